@@ -4,7 +4,7 @@
  * This script implements the RED4ext hook system using Frida's Interceptor API,
  * bypassing Apple Silicon's W^X enforcement through JIT-based trampolines.
  * 
- * @version 1.1.0
+ * @version 1.3.3
  * @author RED4ext macOS Port
  */
 
@@ -24,7 +24,14 @@ const CONFIG = {
     // Module name to hook (main game executable)
     targetModule: 'Cyberpunk2077',
     
-    // Hook offsets from __TEXT segment base
+    // RED4ext library exporting the hook counter table (see src/dll/Platform/FridaHookCounters.hpp)
+    red4extModule: 'RED4ext.dylib',
+    
+    // How often the list of attached diagnostic hooks RED4ext publishes is checked, in milliseconds
+    diagnosticPollInterval: 250,
+    
+    // Hook offsets from __TEXT segment base. Diagnostic hooks are only attached while RED4ext has them attached (see
+    // 'dev.diagnostic_hooks' in config.ini and 'red4ext-ctl diagnostics').
     hooks: {
         // Main function - App startup/shutdown
         0x0E54032B: { name: 'Main', offset: 0x31E18, enabled: true },
@@ -45,7 +52,7 @@ const CONFIG = {
         0x359024C2: { name: 'ScriptValidator_Validate', offset: 0x3D96BFC, enabled: true },
         
         // AssertionFailed - Assertion logging
-        0xFF6B0CB1: { name: 'AssertionFailed', offset: 0x3C3D4C, enabled: true },
+        0xFF6B0CB1: { name: 'AssertionFailed', offset: 0x3C3D4C, enabled: true, diagnostic: true },
         
         // GameInstance::CollectSaveableSystems - Save system
         0xC0886390: { name: 'GameInstance_CollectSaveableSystems', offset: 0x87FEC, enabled: true },
@@ -151,7 +158,6 @@ function formatPtr(ptr) {
 
 let moduleBase = null;
 let hookCount = 0;
-let hookStats = {};
 
 function getModuleBase() {
     if (moduleBase !== null) {
@@ -179,6 +185,204 @@ function getModuleBase() {
     return null;
 }
 
+// ============================================================================
+// Hook Counters
+// ============================================================================
+
+// Layout of 'RED4extFridaHookCounterTable', must match src/dll/Platform/FridaHookCounters.hpp.
+const COUNTERS = {
+    symbol: 'RED4extFridaHookCounters',
+    version: 1,
+    capacityOffset: 4,
+    countOffset: 8,
+    entriesOffset: 16,
+    entrySize: 64,
+    nameSize: 56,
+    callsOffset: 56
+};
+
+let counterTable = null;
+
+function findExport(moduleName, symbol) {
+    const mod = Process.findModuleByName(moduleName);
+    if (mod !== null && typeof mod.findExportByName === 'function') {
+        return mod.findExportByName(symbol);
+    }
+    return Module.findExportByName(moduleName, symbol);
+}
+
+function findCounterTable() {
+    let table = null;
+    try {
+        table = findExport(CONFIG.red4extModule, COUNTERS.symbol);
+    } catch (e) {
+        table = null;
+    }
+    
+    if (table === null) {
+        logInfo(`${CONFIG.red4extModule} does not export '${COUNTERS.symbol}', hook calls will not be counted`);
+        return null;
+    }
+    
+    const version = table.readU32();
+    if (version !== COUNTERS.version) {
+        logError(`Unsupported hook counter table version ${version} (expected ${COUNTERS.version})`);
+        return null;
+    }
+    
+    logDebug(`Hook counter table at ${table}`);
+    return table;
+}
+
+function noCount() {}
+
+/**
+ * Claims an entry of RED4ext's counter table and returns a function counting one call of the hook. The entry and its
+ * addresses are resolved once, a call only writes the counter's memory.
+ */
+function registerCounter(name) {
+    if (counterTable === null) {
+        return noCount;
+    }
+    
+    const capacity = counterTable.add(COUNTERS.capacityOffset).readU32();
+    const count = counterTable.add(COUNTERS.countOffset).readU32();
+    if (count >= capacity) {
+        logError(`No hook counter left for ${name}`);
+        return noCount;
+    }
+    
+    const entry = counterTable.add(COUNTERS.entriesOffset + count * COUNTERS.entrySize);
+    entry.writeUtf8String(name.substring(0, COUNTERS.nameSize - 1));
+    counterTable.add(COUNTERS.countOffset).writeU32(count + 1);
+    
+    // The count is kept here and stored whole, an aligned 64-bit store is a single write RED4ext cannot see half of.
+    const calls = entry.add(COUNTERS.callsOffset);
+    let value = calls.readU64().toNumber();
+    
+    return function() {
+        value++;
+        calls.writeU64(value);
+    };
+}
+
+function readCounters() {
+    const stats = {};
+    if (counterTable === null) {
+        return stats;
+    }
+    
+    const count = counterTable.add(COUNTERS.countOffset).readU32();
+    for (let i = 0; i < count; i++) {
+        const entry = counterTable.add(COUNTERS.entriesOffset + i * COUNTERS.entrySize);
+        stats[entry.readUtf8String()] = entry.add(COUNTERS.callsOffset).readU64().toNumber();
+    }
+    return stats;
+}
+
+// ============================================================================
+// Diagnostic Hooks
+// ============================================================================
+
+// Layout of 'RED4extFridaDiagnosticHookList', must match src/dll/Platform/Hooking.hpp.
+const DIAGNOSTICS = {
+    symbol: 'RED4extFridaDiagnosticHooks',
+    version: 1,
+    generationOffset: 4,
+    countOffset: 8,
+    capacityOffset: 12,
+    hashesOffset: 16
+};
+
+let diagnosticList = null;
+let lastGeneration = 0;
+
+// The diagnostic hooks, attached only while RED4ext lists their hash. 'listener' is set while attached.
+const diagnosticHooks = [];
+
+function findDiagnosticList() {
+    let list = null;
+    try {
+        list = findExport(CONFIG.red4extModule, DIAGNOSTICS.symbol);
+    } catch (e) {
+        list = null;
+    }
+    
+    if (list === null) {
+        logInfo(`${CONFIG.red4extModule} does not export '${DIAGNOSTICS.symbol}', ` +
+                'diagnostic hooks are always attached');
+        return null;
+    }
+    
+    const version = list.readU32();
+    if (version !== DIAGNOSTICS.version) {
+        logError(`Unsupported diagnostic hook list version ${version} (expected ${DIAGNOSTICS.version})`);
+        return null;
+    }
+    
+    return list;
+}
+
+/**
+ * Reads the hashes of the diagnostic hooks RED4ext has attached, or null when the list did not change since the last
+ * call or is being written. RED4ext makes the generation odd while it writes the list.
+ */
+function readDiagnosticHashes() {
+    const generation = diagnosticList.add(DIAGNOSTICS.generationOffset).readU32();
+    if (generation === lastGeneration || (generation & 1) !== 0) {
+        return null;
+    }
+    
+    const capacity = diagnosticList.add(DIAGNOSTICS.capacityOffset).readU32();
+    const count = Math.min(diagnosticList.add(DIAGNOSTICS.countOffset).readU32(), capacity);
+    
+    const hashes = [];
+    for (let i = 0; i < count; i++) {
+        hashes.push(diagnosticList.add(DIAGNOSTICS.hashesOffset + i * 4).readU32());
+    }
+    
+    if (diagnosticList.add(DIAGNOSTICS.generationOffset).readU32() !== generation) {
+        return null;
+    }
+    
+    lastGeneration = generation;
+    return hashes;
+}
+
+function attachDiagnosticHook(hook) {
+    try {
+        hook.listener = hook.install(hook.address, hook.countCall);
+        logInfo(`Diagnostic hook ${hook.name} attached at ${hook.address}`);
+    } catch (e) {
+        logError(`Diagnostic hook ${hook.name} - ${e.message}`);
+    }
+}
+
+function syncDiagnosticHooks() {
+    const hashes = readDiagnosticHashes();
+    if (hashes === null) {
+        return;
+    }
+    
+    let changed = false;
+    for (const hook of diagnosticHooks) {
+        const wanted = hashes.includes(hook.hash);
+        if (wanted && hook.listener === null) {
+            attachDiagnosticHook(hook);
+            changed = true;
+        } else if (!wanted && hook.listener !== null) {
+            hook.listener.detach();
+            hook.listener = null;
+            logInfo(`Diagnostic hook ${hook.name} detached`);
+            changed = true;
+        }
+    }
+    
+    if (changed) {
+        Interceptor.flush();
+    }
+}
+
 // ============================================================================
 // Hook Handlers
 // ============================================================================
@@ -186,14 +390,14 @@ function getModuleBase() {
 /**
  * Hook: Main
  */
-function hookMain(address) {
+function hookMain(address, countCall) {
     let gameStartTime = null;
     
-    Interceptor.attach(address, {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
             gameStartTime = Date.now();
             logInfo('Main() called - Game starting');
-            hookStats['Main'] = (hookStats['Main'] || 0) + 1;
+            countCall();
         },
         onLeave: function(retval) {
             const elapsed = gameStartTime ? (Date.now() - gameStartTime) : 0;
@@ -205,10 +409,10 @@ function hookMain(address) {
 /**
  * Hook: CGameApplication::AddState
  */
-function hookCGameApplication_AddState(address) {
-    Interceptor.attach(address, {
+function hookCGameApplication_AddState(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['AddState'] = (hookStats['AddState'] || 0) + 1;
+            countCall();
             logInfo('CGameApplication::AddState called');
             logTrace(`  this: ${formatPtr(args[0])}, state: ${formatPtr(args[1])}`);
         },
@@ -221,10 +425,10 @@ function hookCGameApplication_AddState(address) {
 /**
  * Hook: Global::ExecuteProcess
  */
-function hookGlobal_ExecuteProcess(address) {
-    Interceptor.attach(address, {
+function hookGlobal_ExecuteProcess(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['ExecuteProcess'] = (hookStats['ExecuteProcess'] || 0) + 1;
+            countCall();
             
             // Try to read command string safely
             const commandPtr = args[1];
@@ -260,10 +464,10 @@ function hookGlobal_ExecuteProcess(address) {
 /**
  * Hook: CBaseEngine::InitScripts
  */
-function hookCBaseEngine_InitScripts(address) {
-    Interceptor.attach(address, {
+function hookCBaseEngine_InitScripts(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['InitScripts'] = (hookStats['InitScripts'] || 0) + 1;
+            countCall();
             logInfo('CBaseEngine::InitScripts called');
         },
         onLeave: function(retval) {
@@ -275,10 +479,10 @@ function hookCBaseEngine_InitScripts(address) {
 /**
  * Hook: CBaseEngine::LoadScripts
  */
-function hookCBaseEngine_LoadScripts(address) {
-    Interceptor.attach(address, {
+function hookCBaseEngine_LoadScripts(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['LoadScripts'] = (hookStats['LoadScripts'] || 0) + 1;
+            countCall();
             logInfo('CBaseEngine::LoadScripts called');
         },
         onLeave: function(retval) {
@@ -290,10 +494,10 @@ function hookCBaseEngine_LoadScripts(address) {
 /**
  * Hook: ScriptValidator::Validate
  */
-function hookScriptValidator_Validate(address) {
-    Interceptor.attach(address, {
+function hookScriptValidator_Validate(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['Validate'] = (hookStats['Validate'] || 0) + 1;
+            countCall();
             logDebug('ScriptValidator::Validate called');
         },
         onLeave: function(retval) {
@@ -308,10 +512,10 @@ function hookScriptValidator_Validate(address) {
 /**
  * Hook: AssertionFailed
  */
-function hookAssertionFailed(address) {
-    Interceptor.attach(address, {
+function hookAssertionFailed(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['AssertionFailed'] = (hookStats['AssertionFailed'] || 0) + 1;
+            countCall();
             
             logError('=== ASSERTION FAILED ===');
             
@@ -333,10 +537,10 @@ function hookAssertionFailed(address) {
 /**
  * Hook: GameInstance::CollectSaveableSystems
  */
-function hookGameInstance_CollectSaveableSystems(address) {
-    Interceptor.attach(address, {
+function hookGameInstance_CollectSaveableSystems(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['CollectSaveableSystems'] = (hookStats['CollectSaveableSystems'] || 0) + 1;
+            countCall();
             logDebug('GameInstance::CollectSaveableSystems called');
         }
     });
@@ -345,10 +549,10 @@ function hookGameInstance_CollectSaveableSystems(address) {
 /**
  * Hook: GsmState_SessionActive::ReportErrorCode
  */
-function hookGsmState_SessionActive_ReportErrorCode(address) {
-    Interceptor.attach(address, {
+function hookGsmState_SessionActive_ReportErrorCode(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['ReportErrorCode'] = (hookStats['ReportErrorCode'] || 0) + 1;
+            countCall();
             
             const errorCode = safeReadInt32(args[1]);
             if (errorCode !== null && errorCode !== 0) {
@@ -365,10 +569,10 @@ function hookGsmState_SessionActive_ReportErrorCode(address) {
 /**
  * Hook: TweakDB_Init - Database initialization
  */
-function hookTweakDB_Init(address) {
-    Interceptor.attach(address, {
+function hookTweakDB_Init(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['TweakDB_Init'] = (hookStats['TweakDB_Init'] || 0) + 1;
+            countCall();
             logInfo('TweakDB::Init called - TweakDB initializing');
             logTrace(`  this: ${formatPtr(args[0])}, arg1: ${formatPtr(args[1])}`);
         },
@@ -381,10 +585,10 @@ function hookTweakDB_Init(address) {
 /**
  * Hook: TweakDB_Load - Load optimized database
  */
-function hookTweakDB_Load(address) {
-    Interceptor.attach(address, {
+function hookTweakDB_Load(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['TweakDB_Load'] = (hookStats['TweakDB_Load'] || 0) + 1;
+            countCall();
             logInfo('TweakDB::Load called - Loading TweakDB');
             
             // Try to read the path argument (CString)
@@ -408,10 +612,10 @@ function hookTweakDB_Load(address) {
 /**
  * Hook: TweakDB_TryLoad - Try loading database
  */
-function hookTweakDB_TryLoad(address) {
-    Interceptor.attach(address, {
+function hookTweakDB_TryLoad(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['TweakDB_TryLoad'] = (hookStats['TweakDB_TryLoad'] || 0) + 1;
+            countCall();
             logInfo('TweakDB::TryLoad called');
         },
         onLeave: function(retval) {
@@ -424,10 +628,10 @@ function hookTweakDB_TryLoad(address) {
 /**
  * Hook: TweakDB_CreateRecord - Create database record
  */
-function hookTweakDB_CreateRecord(address) {
-    Interceptor.attach(address, {
+function hookTweakDB_CreateRecord(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['TweakDB_CreateRecord'] = (hookStats['TweakDB_CreateRecord'] || 0) + 1;
+            countCall();
             logDebug('TweakDB::CreateRecord called');
             
             // args[0] = this (TweakDB*)
@@ -444,10 +648,10 @@ function hookTweakDB_CreateRecord(address) {
 /**
  * Hook: TweakDBID_Derive - Derive TweakDB ID from base
  */
-function hookTweakDBID_Derive(address) {
-    Interceptor.attach(address, {
+function hookTweakDBID_Derive(address, countCall) {
+    return Interceptor.attach(address, {
         onEnter: function(args) {
-            hookStats['TweakDBID_Derive'] = (hookStats['TweakDBID_Derive'] || 0) + 1;
+            countCall();
             
             // args[2] = name string
             const nameStr = safeReadCString(args[2]);
@@ -492,11 +696,13 @@ function installHooks() {
     }
     
     logInfo(`Module base: ${base}`);
+    counterTable = findCounterTable();
+    diagnosticList = findDiagnosticList();
     logInfo('');
     logInfo('Installing hooks...');
     
     for (const [hashStr, hookInfo] of Object.entries(CONFIG.hooks)) {
-        const { name, offset, enabled } = hookInfo;
+        const { name, offset, enabled, diagnostic } = hookInfo;
         
         if (!enabled) {
             logDebug(`  [SKIP] ${name} (disabled)`);
@@ -509,9 +715,18 @@ function installHooks() {
             continue;
         }
         
+        if (diagnostic && diagnosticList !== null) {
+            const address = base.add(offset);
+            const countCall = registerCounter(name);
+            const hash = Number(hashStr);
+            diagnosticHooks.push({ name, hash, address, install: hookFunc, countCall, listener: null });
+            logInfo(`  [DEFER] ${name} at ${address} (diagnostic, attached on demand)`);
+            continue;
+        }
+        
         try {
             const address = base.add(offset);
-            hookFunc(address);
+            hookFunc(address, registerCounter(name));
             hookCount++;
             logInfo(`  [OK] ${name} at ${address} (offset 0x${offset.toString(16)})`);
         } catch (e) {
@@ -520,8 +735,15 @@ function installHooks() {
     }
     
     logInfo('');
-    console.log(`${CONFIG.logPrefix} Hook installation complete: ${hookCount}/${Object.keys(CONFIG.hooks).length} hooks active`);
+    const total = Object.keys(CONFIG.hooks).length;
+    console.log(`${CONFIG.logPrefix} Hook installation complete: ${hookCount}/${total} hooks active, ` +
+                `${diagnosticHooks.length} diagnostic hook(s) on demand`);
     console.log(`${CONFIG.logPrefix} ========================================`);
+    
+    if (diagnosticHooks.length > 0) {
+        syncDiagnosticHooks();
+        setInterval(syncDiagnosticHooks, CONFIG.diagnosticPollInterval);
+    }
 }
 
 // ============================================================================
@@ -537,7 +759,7 @@ rpc.exports = {
     },
     
     getHookStats: function() {
-        return JSON.stringify(hookStats);
+        return JSON.stringify(readCounters());
     },
     
     setLogLevel: function(level) {
@@ -0,0 +1,203 @@
+#include "stdafx.hpp"
+#include "PoolAllocator.hpp"
+
+#include <barrier>
+#include <cstdlib>
+
+/*
+ * Multithreaded churn of small objects, the pool arena against the system allocator.
+ *
+ *  local  - every thread frees what it allocated.
+ *  remote - batches are handed to the next thread, which frees them (exercises the remote-free queue).
+ */
+namespace
+{
+constexpr size_t OperationsPerThread = 2'000'000;
+constexpr size_t LiveSlots = 4096;
+constexpr size_t BatchSize = 1024;
+
+struct SystemAllocator
+{
+    static constexpr auto Name = "system";
+
+    void* Allocate(size_t aSize)
+    {
+        return std::malloc(aSize);
+    }
+
+    void Free(void* aPtr)
+    {
+        std::free(aPtr);
+    }
+};
+
+struct PoolAllocator
+{
+    static constexpr auto Name = "pool";
+
+    void* Allocate(size_t aSize)
+    {
+        return arena.Allocate(aSize);
+    }
+
+    void Free(void* aPtr)
+    {
+        PoolArena::Free(aPtr);
+    }
+
+    PoolArena arena;
+};
+
+class Random
+{
+public:
+    explicit Random(uint64_t aSeed)
+        : m_state(aSeed * 0x9E3779B97F4A7C15ull + 1)
+    {
+    }
+
+    uint64_t Next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state;
+    }
+
+    // Mostly small objects, with the occasional block at the top of the size classes.
+    size_t NextSize()
+    {
+        auto value = Next();
+        return (value & 63) == 0 ? 512 + (value >> 8) % 3584 : 8 + (value >> 8) % 248;
+    }
+
+private:
+    uint64_t m_state;
+};
+
+void* Touch(void* aPtr)
+{
+    *static_cast<volatile char*>(aPtr) = 1;
+    return aPtr;
+}
+
+template<typename Allocator>
+void LocalChurn(Allocator& aAllocator, size_t aThread)
+{
+    Random random(aThread);
+    std::vector<void*> slots(LiveSlots, nullptr);
+
+    for (size_t i = 0; i < OperationsPerThread; i++)
+    {
+        auto& slot = slots[random.Next() % LiveSlots];
+        aAllocator.Free(slot);
+        slot = Touch(aAllocator.Allocate(random.NextSize()));
+    }
+
+    for (auto ptr : slots)
+    {
+        aAllocator.Free(ptr);
+    }
+}
+
+template<typename Allocator>
+void RemoteChurn(Allocator& aAllocator, size_t aThread, size_t aThreads, std::vector<std::vector<void*>>& aMailboxes,
+                 std::barrier<>& aBarrier)
+{
+    Random random(aThread);
+    auto& outgoing = aMailboxes[(aThread + 1) % aThreads];
+    auto& incoming = aMailboxes[aThread];
+
+    for (size_t i = 0; i < OperationsPerThread / BatchSize; i++)
+    {
+        for (size_t j = 0; j < BatchSize; j++)
+        {
+            outgoing[j] = Touch(aAllocator.Allocate(random.NextSize()));
+        }
+
+        aBarrier.arrive_and_wait();
+
+        for (auto ptr : incoming)
+        {
+            aAllocator.Free(ptr);
+        }
+
+        aBarrier.arrive_and_wait();
+    }
+}
+
+template<typename Allocator>
+double Run(bool aRemote, size_t aThreads)
+{
+    Allocator allocator;
+
+    std::vector<std::vector<void*>> mailboxes(aThreads, std::vector<void*>(BatchSize, nullptr));
+    std::barrier barrier(static_cast<std::ptrdiff_t>(aThreads));
+
+    std::vector<std::thread> threads;
+    threads.reserve(aThreads);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < aThreads; i++)
+    {
+        threads.emplace_back(
+            [&, i]()
+            {
+                if (aRemote)
+                {
+                    RemoteChurn(allocator, i, aThreads, mailboxes, barrier);
+                }
+                else
+                {
+                    LocalChurn(allocator, i);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Each operation is an allocation and a free.
+    return static_cast<double>(OperationsPerThread * aThreads) / elapsed.count() / 1'000'000.0;
+}
+
+template<typename Allocator>
+void Report(bool aRemote, size_t aThreads)
+{
+    auto rate = Run<Allocator>(aRemote, aThreads);
+    fmt::print("{:<8} {:<8} {:>3} thread(s): {:>8.2f} Mops/s\n", Allocator::Name, aRemote ? "remote" : "local",
+               aThreads, rate);
+}
+} // namespace
+
+int main()
+{
+    std::vector<size_t> threadCounts = {1, 2, 4, 8};
+
+    const auto hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads > threadCounts.back())
+    {
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    for (auto remote : {false, true})
+    {
+        for (auto threads : threadCounts)
+        {
+            // The remote scenario needs a neighbour to hand the batches to.
+            if (remote && threads == 1)
+            {
+                continue;
+            }
+
+            Report<SystemAllocator>(remote, threads);
+            Report<PoolAllocator>(remote, threads);
+        }
+    }
+
+    return 0;
+}
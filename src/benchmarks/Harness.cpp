@@ -0,0 +1,193 @@
+#include "Harness.hpp"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+Harness::Layout Harness::CreateLayout(const std::filesystem::path& aRoot, const std::filesystem::path& aExe,
+                                      bool aIsGame)
+{
+    Layout layout;
+    layout.root = aRoot;
+    layout.plugins = aRoot / "red4ext" / "plugins";
+
+    auto contents = aRoot / "Cyberpunk2077.app" / "Contents";
+    layout.exe = contents / "MacOS" / "Cyberpunk2077";
+
+    std::filesystem::create_directories(layout.exe.parent_path());
+
+    if (aIsGame)
+    {
+        std::ofstream plist(contents / "Info.plist");
+        plist << R"(<?xml version="1.0" encoding="UTF-8"?>
+<!DOCTYPE plist PUBLIC "-//Apple//DTD PLIST 1.0//EN" "http://www.apple.com/DTDs/PropertyList-1.0.dtd">
+<plist version="1.0">
+<dict>
+    <key>CFBundleExecutable</key>
+    <string>Cyberpunk2077</string>
+    <key>CFBundleIdentifier</key>
+    <string>com.cdprojektred.cyberpunk2077</string>
+    <key>CFBundleShortVersionString</key>
+    <string>2.3.1</string>
+</dict>
+</plist>
+)";
+    }
+
+    std::filesystem::copy_file(aExe, layout.exe);
+    std::filesystem::create_directories(layout.plugins);
+
+    return layout;
+}
+
+void Harness::InstallPlugins(const Layout& aLayout, const std::filesystem::path& aPlugin, size_t aCount,
+                             std::string_view aConfig)
+{
+    for (size_t i = 0; i < aCount; i++)
+    {
+        auto name = fmt::format("Synthetic{:03}", i);
+        auto dir = aLayout.plugins / name;
+
+        std::filesystem::create_directories(dir);
+        std::filesystem::copy_file(aPlugin, dir / (name + PluginExtension));
+
+        if (!aConfig.empty())
+        {
+            std::ofstream config(dir / (name + ".ini"));
+            config << aConfig;
+        }
+    }
+}
+
+std::vector<std::string> Harness::GetInjectionEnv(const std::filesystem::path& aLibrary)
+{
+    return {"DYLD_INSERT_LIBRARIES=" + aLibrary.string(), "DYLD_FORCE_FLAT_NAMESPACE=1"};
+}
+
+std::optional<Harness::Result> Harness::Run(const std::filesystem::path& aExe, const std::vector<std::string>& aArgs,
+                                            const std::vector<std::string>& aEnv)
+{
+    std::vector<std::string> env;
+    for (auto var = environ; *var; var++)
+    {
+        env.emplace_back(*var);
+    }
+
+    env.insert(env.end(), aEnv.begin(), aEnv.end());
+
+    std::vector<char*> envp;
+    for (auto& var : env)
+    {
+        envp.push_back(var.data());
+    }
+
+    envp.push_back(nullptr);
+
+    auto exe = aExe.string();
+    auto args = aArgs;
+
+    std::vector<char*> argv = {exe.data()};
+    for (auto& arg : args)
+    {
+        argv.push_back(arg.data());
+    }
+
+    argv.push_back(nullptr);
+
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return std::nullopt;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], ReportFd);
+    if (fds[1] != ReportFd)
+    {
+        posix_spawn_file_actions_addclose(&actions, fds[1]);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    pid_t pid;
+    auto error = posix_spawn(&pid, exe.c_str(), &actions, nullptr, argv.data(), envp.data());
+
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (error != 0)
+    {
+        close(fds[0]);
+        fmt::print(stderr, "Could not start '{}': {}\n", exe, std::strerror(error));
+        return std::nullopt;
+    }
+
+    Result result;
+
+    auto report = fdopen(fds[0], "r");
+    if (report)
+    {
+        char line[256];
+        while (std::fgets(line, sizeof(line), report))
+        {
+            char key[64];
+            double value;
+            if (std::sscanf(line, "%63s %lf", key, &value) != 2)
+            {
+                continue;
+            }
+
+            if (std::string_view(key) == "ready")
+            {
+                const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                result.readyMs = elapsed.count();
+            }
+
+            result.values[key] = value;
+        }
+
+        std::fclose(report);
+    }
+    else
+    {
+        close(fds[0]);
+    }
+
+    int status;
+    rusage usage{};
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || !report)
+    {
+        fmt::print(stderr, "'{}' did not complete the run\n", exe);
+        return std::nullopt;
+    }
+
+    // Bytes on macOS.
+    result.peakRssMb = static_cast<double>(usage.ru_maxrss) / (1024 * 1024);
+
+    return result;
+}
+
+FILE* Harness::OpenReport()
+{
+    return fdopen(ReportFd, "w");
+}
+
+void Harness::Report(FILE* aReport, std::string_view aKey, double aValue)
+{
+    if (aReport)
+    {
+        fmt::print(aReport, "{} {}\n", aKey, aValue);
+        std::fflush(aReport);
+    }
+}
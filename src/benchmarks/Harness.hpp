@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Shared by the benchmarks that run RED4ext in a child process. The child writes "key value" lines to 'ReportFd', the
+ * parent collects them.
+ */
+namespace Harness
+{
+constexpr int ReportFd = 3;
+
+constexpr auto PluginExtension = ".dylib";
+
+struct Layout
+{
+    std::filesystem::path root;
+    std::filesystem::path exe;
+    std::filesystem::path plugins;
+};
+
+struct Result
+{
+    std::unordered_map<std::string, double> values;
+
+    // Time between the start of the process and its "ready" report.
+    double readyMs = 0;
+    double peakRssMb = 0;
+};
+
+// Mirrors the layout 'Paths' derives the game's root directory from, 'Image' only recognizes the bundle as the game
+// when 'aIsGame' is set.
+Layout CreateLayout(const std::filesystem::path& aRoot, const std::filesystem::path& aExe, bool aIsGame);
+
+// Copies the plugin into its own directory 'aCount' times, 'aConfig' is written next to every copy.
+void InstallPlugins(const Layout& aLayout, const std::filesystem::path& aPlugin, size_t aCount,
+                    std::string_view aConfig = {});
+
+// Environment variables that inject the library the same way the launcher does.
+std::vector<std::string> GetInjectionEnv(const std::filesystem::path& aLibrary);
+
+std::optional<Result> Run(const std::filesystem::path& aExe, const std::vector<std::string>& aArgs,
+                          const std::vector<std::string>& aEnv = {});
+
+// The child's end of the report, nullptr when it was not started by 'Run'.
+FILE* OpenReport();
+void Report(FILE* aReport, std::string_view aKey, double aValue);
+} // namespace Harness
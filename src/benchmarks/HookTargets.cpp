@@ -0,0 +1,89 @@
+#include "HookTargets.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <utility>
+
+#define RED4EXT_BENCHMARK_EXPORT extern "C" [[gnu::visibility("default")]]
+
+namespace
+{
+constexpr size_t TargetCount = 1024;
+
+// Kept long enough for a 16 byte patch and free of PC-relative instructions in the prologue.
+template<size_t N>
+[[gnu::noinline]] int Target(int aValue)
+{
+    for (auto i = 0; i < 4; i++)
+    {
+        asm volatile("" : "+r"(aValue));
+        aValue = aValue * 31 + static_cast<int>(N);
+    }
+
+    return aValue;
+}
+
+template<size_t... I>
+constexpr std::array<HookTargets::Target_t, sizeof...(I)> MakeTargets(std::index_sequence<I...>)
+{
+    return {&Target<I>...};
+}
+
+constexpr auto Targets = MakeTargets(std::make_index_sequence<TargetCount>());
+
+std::atomic<size_t> g_nextTarget{HookTargets::SharedCount};
+std::atomic<size_t> g_requestedHooks{0};
+std::atomic<size_t> g_attachedHooks{0};
+} // namespace
+
+std::span<const HookTargets::Target_t> HookTargets::GetHandedOut()
+{
+    auto count = std::min(g_nextTarget.load(std::memory_order_relaxed), Targets.size());
+    return std::span(Targets).first(count);
+}
+
+HookTargets::Target_t HookTargets::GetFirstUnique()
+{
+    return Targets[SharedCount];
+}
+
+size_t HookTargets::GetRequestedHooks()
+{
+    return g_requestedHooks.load(std::memory_order_relaxed);
+}
+
+size_t HookTargets::GetAttachedHooks()
+{
+    return g_attachedHooks.load(std::memory_order_relaxed);
+}
+
+uint64_t HookTargets::GetDetourCalls()
+{
+    return RED4extBenchmark_DetourCalls;
+}
+
+extern "C"
+{
+[[gnu::visibility("default")]] uint64_t RED4extBenchmark_DetourCalls = 0;
+}
+
+RED4EXT_BENCHMARK_EXPORT void* RED4extBenchmark_SharedTarget(uint32_t aIndex)
+{
+    return aIndex < HookTargets::SharedCount ? reinterpret_cast<void*>(Targets[aIndex]) : nullptr;
+}
+
+RED4EXT_BENCHMARK_EXPORT void* RED4extBenchmark_NextTarget()
+{
+    auto index = g_nextTarget.fetch_add(1, std::memory_order_relaxed);
+    return index < Targets.size() ? reinterpret_cast<void*>(Targets[index]) : nullptr;
+}
+
+RED4EXT_BENCHMARK_EXPORT void RED4extBenchmark_ReportHook(bool aIsAttached)
+{
+    g_requestedHooks.fetch_add(1, std::memory_order_relaxed);
+    if (aIsAttached)
+    {
+        g_attachedHooks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/*
+ * Functions the synthetic plugins hook in the process that loads them. The plugins find them with 'dlsym':
+ *
+ *  RED4extBenchmark_SharedTarget(index) - one of the few targets every plugin may hook.
+ *  RED4extBenchmark_NextTarget()        - a target no other hook was given, nullptr once all of them are taken.
+ *  RED4extBenchmark_ReportHook(result)  - counts the outcome of an attach request.
+ *  RED4extBenchmark_DetourCalls         - bumped by the detours, stays at zero when the hooks did not patch anything
+ *                                         (Frida Gadget mode).
+ */
+namespace HookTargets
+{
+using Target_t = int (*)(int);
+
+constexpr size_t SharedCount = 8;
+
+// The shared targets first, then the unique ones in the order they were handed out.
+std::span<const Target_t> GetHandedOut();
+Target_t GetFirstUnique();
+
+size_t GetRequestedHooks();
+size_t GetAttachedHooks();
+uint64_t GetDetourCalls();
+} // namespace HookTargets
+
+extern "C"
+{
+void* RED4extBenchmark_SharedTarget(uint32_t aIndex);
+void* RED4extBenchmark_NextTarget();
+void RED4extBenchmark_ReportHook(bool aIsAttached);
+
+// Only the thread calling the targets writes it, a plain counter keeps the detours cheap.
+extern uint64_t RED4extBenchmark_DetourCalls;
+}
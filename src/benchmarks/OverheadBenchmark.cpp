@@ -0,0 +1,226 @@
+#include "Harness.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <unistd.h>
+
+/*
+ * Measures what RED4ext adds to a process against the targets of the macOS port (see
+ * 'docs/porting/MACOS_PORT_COMPLETE_DEFINITION.md', section 4.1), exits with a non-zero code when one is exceeded.
+ *
+ * The stand-in host is started in a game-like layout three ways:
+ *
+ *  baseline - without RED4ext.
+ *  empty    - with RED4ext injected like the launcher does and no plugin installed.
+ *  loaded   - with RED4ext injected and N synthetic plugins, each hooking one of the host's functions.
+ */
+namespace
+{
+constexpr auto HostName = "RED4ext.Benchmarks.Host";
+constexpr auto PluginName = "RED4ext.Benchmarks.Plugin";
+
+struct Options
+{
+    std::filesystem::path library;
+    size_t plugins = 100;
+    size_t runs = 5;
+    size_t idleFrames = 300;
+};
+
+struct Sample
+{
+    double startupMs = 0;
+    double rssMb = 0;
+    double callNs = 0;
+    double idleCpu = 0;
+
+    // Calls of the timed loop that went through a detour, zero when nothing was patched.
+    double detourCalls = 0;
+};
+
+struct Limit
+{
+    const char* name;
+    const char* unit;
+    double value;
+};
+
+constexpr Limit StartupLimit{"Startup time increase", "ms", 300};
+constexpr Limit MemoryLimit{"Memory overhead", "MB", 75};
+constexpr Limit HookLimit{"Hook call overhead", "ns", 7};
+constexpr Limit DiscoveryLimit{"Plugin discovery (100 plugins)", "ms", 75};
+constexpr Limit CpuLimit{"CPU overhead (idle)", "%", 0.15};
+
+std::optional<Options> ParseOptions(int aArgc, char** aArgv)
+{
+    Options options;
+    for (auto i = 1; i < aArgc; i++)
+    {
+        std::string_view arg = aArgv[i];
+        auto next = [&]() { return i + 1 < aArgc ? std::strtoull(aArgv[++i], nullptr, 10) : 0; };
+
+        if (arg == "--plugins")
+        {
+            options.plugins = next();
+        }
+        else if (arg == "--runs")
+        {
+            options.runs = next();
+        }
+        else if (arg == "--idle-frames")
+        {
+            options.idleFrames = next();
+        }
+        else if (options.library.empty() && !arg.starts_with("--"))
+        {
+            options.library = std::filesystem::absolute(arg);
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (options.library.empty() || options.runs == 0)
+    {
+        return std::nullopt;
+    }
+
+    return options;
+}
+
+std::optional<Sample> Run(const std::filesystem::path& aExe, const std::filesystem::path* aLibrary, size_t aIdleFrames)
+{
+    auto env = aLibrary ? Harness::GetInjectionEnv(*aLibrary) : std::vector<std::string>{};
+
+    auto result = Harness::Run(aExe, {std::to_string(aIdleFrames)}, env);
+    if (!result)
+    {
+        return std::nullopt;
+    }
+
+    auto& values = result->values;
+    if (!values.contains("call_ns") || !values.contains("idle_cpu") || !values.contains("detour_calls"))
+    {
+        return std::nullopt;
+    }
+
+    return Sample{result->readyMs, result->peakRssMb, values["call_ns"], values["idle_cpu"], values["detour_calls"]};
+}
+
+// The median of every field, so a single noisy run does not decide the outcome.
+Sample Median(std::vector<Sample> aSamples)
+{
+    auto median = [&aSamples](double Sample::*aField)
+    {
+        std::vector<double> values;
+        for (const auto& sample : aSamples)
+        {
+            values.push_back(sample.*aField);
+        }
+
+        std::ranges::sort(values);
+        return values[values.size() / 2];
+    };
+
+    return {median(&Sample::startupMs), median(&Sample::rssMb), median(&Sample::callNs), median(&Sample::idleCpu),
+            median(&Sample::detourCalls)};
+}
+
+bool Check(const Limit& aLimit, double aValue)
+{
+    const auto isPassing = aValue < aLimit.value;
+    fmt::print("{:<32} {:>10.3f} {:<2} (limit {} {}) {}\n", aLimit.name, aValue, aLimit.unit, aLimit.value,
+               aLimit.unit, isPassing ? "pass" : "FAIL");
+
+    return isPassing;
+}
+} // namespace
+
+int main(int aArgc, char** aArgv)
+{
+    auto options = ParseOptions(aArgc, aArgv);
+    if (!options)
+    {
+        fmt::print(stderr, "Usage: {} <RED4ext library> [--plugins N] [--runs N] [--idle-frames N]\n", aArgv[0]);
+        return 2;
+    }
+
+    const auto binDir = std::filesystem::absolute(aArgv[0]).parent_path();
+    const auto host = binDir / HostName;
+    const auto plugin = binDir / (std::string(PluginName) + Harness::PluginExtension);
+
+    const auto root = std::filesystem::temp_directory_path() / fmt::format("red4ext-overhead-{}", getpid());
+    std::filesystem::remove_all(root);
+
+    const auto emptyLayout = Harness::CreateLayout(root / "empty", host, true);
+    const auto loadedLayout = Harness::CreateLayout(root / "loaded", host, true);
+    Harness::InstallPlugins(loadedLayout, plugin, options->plugins);
+
+    std::vector<Sample> baseline, empty, loaded;
+    auto isComplete = true;
+
+    for (size_t i = 0; i < options->runs && isComplete; i++)
+    {
+        fmt::print("Run {}/{}...\n", i + 1, options->runs);
+
+        auto baselineSample = Run(emptyLayout.exe, nullptr, options->idleFrames);
+        auto emptySample = Run(emptyLayout.exe, &options->library, options->idleFrames);
+        auto loadedSample = Run(loadedLayout.exe, &options->library, options->idleFrames);
+
+        isComplete = baselineSample && emptySample && loadedSample;
+        if (isComplete)
+        {
+            baseline.push_back(*baselineSample);
+            empty.push_back(*emptySample);
+            loaded.push_back(*loadedSample);
+        }
+    }
+
+    std::filesystem::remove_all(root);
+
+    if (!isComplete)
+    {
+        return 1;
+    }
+
+    const auto base = Median(std::move(baseline));
+    const auto bare = Median(std::move(empty));
+    const auto full = Median(std::move(loaded));
+
+    fmt::print("\n{:<8} {:>12} {:>10} {:>10} {:>10}\n", "", "startup ms", "rss MB", "call ns", "idle cpu %");
+    for (const auto& [name, sample] : {std::pair{"baseline", base}, std::pair{"empty", bare}, std::pair{"loaded", full}})
+    {
+        fmt::print("{:<8} {:>12.2f} {:>10.2f} {:>10.3f} {:>10.4f}\n", name, sample.startupMs, sample.rssMb,
+                   sample.callNs, sample.idleCpu * 100);
+    }
+
+    fmt::print("\n");
+
+    auto isPassing = true;
+    isPassing &= Check(StartupLimit, full.startupMs - base.startupMs);
+    isPassing &= Check(MemoryLimit, full.rssMb - base.rssMb);
+    isPassing &= Check(CpuLimit, (full.idleCpu - base.idleCpu) * 100);
+
+    if (options->plugins > 0)
+    {
+        // Only the first target is timed, it carries a single hook. Without a patched target (Frida Gadget mode) the
+        // calls never reach the detour and there is nothing to measure.
+        if (full.detourCalls > 0)
+        {
+            isPassing &= Check(HookLimit, full.callNs - base.callNs);
+        }
+        else
+        {
+            fmt::print("{:<32} skipped, no call reached a detour (was RED4ext built in Frida Gadget mode?)\n",
+                       HookLimit.name);
+        }
+
+        isPassing &= Check(DiscoveryLimit, (full.startupMs - bare.startupMs) * 100 / options->plugins);
+    }
+
+    return isPassing ? 0 : 1;
+}
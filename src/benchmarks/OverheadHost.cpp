@@ -0,0 +1,79 @@
+#include "Harness.hpp"
+#include "HookTargets.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include <sys/resource.h>
+
+/*
+ * Stand-in for the game executable, driven by 'RED4ext.Benchmarks.Overhead'.
+ *
+ * It reports when 'main' is reached, times calls through the first unique hook target and how many of them reached a
+ * detour, then idles at 60 frames per second, calling every target that was handed out once per frame.
+ */
+namespace
+{
+constexpr size_t CallIterations = 20'000'000;
+constexpr std::chrono::milliseconds FrameTime(16);
+
+std::chrono::microseconds GetCpuTime()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    auto toMicroseconds = [](const timeval& aTime)
+    { return std::chrono::seconds(aTime.tv_sec) + std::chrono::microseconds(aTime.tv_usec); };
+
+    return toMicroseconds(usage.ru_utime) + toMicroseconds(usage.ru_stime);
+}
+} // namespace
+
+int main(int aArgc, char** aArgv)
+{
+    auto report = Harness::OpenReport();
+    Harness::Report(report, "ready", 1);
+
+    const auto idleFrames = aArgc > 1 ? std::strtoul(aArgv[1], nullptr, 10) : 300;
+
+    // Called through a volatile pointer so the loop cannot be folded into the caller.
+    volatile HookTargets::Target_t target = HookTargets::GetFirstUnique();
+    auto value = 0;
+
+    const auto detourCallsBefore = HookTargets::GetDetourCalls();
+    const auto callStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < CallIterations; i++)
+    {
+        value = target(value);
+    }
+
+    const std::chrono::duration<double, std::nano> callElapsed = std::chrono::steady_clock::now() - callStart;
+    Harness::Report(report, "call_ns", callElapsed.count() / CallIterations);
+    Harness::Report(report, "detour_calls", static_cast<double>(HookTargets::GetDetourCalls() - detourCallsBefore));
+
+    const auto idleStart = std::chrono::steady_clock::now();
+    const auto cpuStart = GetCpuTime();
+
+    for (unsigned long frame = 0; frame < idleFrames; frame++)
+    {
+        for (auto fn : HookTargets::GetHandedOut())
+        {
+            value = fn(value);
+        }
+
+        std::this_thread::sleep_for(FrameTime);
+    }
+
+    const std::chrono::duration<double> cpuElapsed = GetCpuTime() - cpuStart;
+    const std::chrono::duration<double> idleElapsed = std::chrono::steady_clock::now() - idleStart;
+    Harness::Report(report, "idle_cpu", cpuElapsed.count() / idleElapsed.count());
+
+    if (report)
+    {
+        std::fclose(report);
+    }
+
+    asm volatile("" : : "r"(value));
+    return 0;
+}
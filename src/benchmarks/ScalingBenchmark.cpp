@@ -0,0 +1,266 @@
+#include "stdafx.hpp"
+#include "App.hpp"
+#include "Harness.hpp"
+#include "HookTargets.hpp"
+
+#include <mach/mach.h>
+#include <unistd.h>
+
+/*
+ * How the plugin, hooking, state and logger systems scale with the number of plugins.
+ *
+ * For every plugin count K the driver generates a game-like layout with K copies of the synthetic plugin and their
+ * settings, then starts itself from that layout with '--child'. The child runs RED4ext in-process: it constructs and
+ * starts the real 'App', drives 'StateSystem::OnUpdate' for a number of frames and reports the load time, the frame
+ * cost and the memory RED4ext added.
+ */
+namespace
+{
+constexpr auto PluginName = "RED4ext.Benchmarks.Plugin";
+
+struct Options
+{
+    std::vector<size_t> counts = {0, 10, 25, 50, 100, 200};
+    size_t sharedHooks = 1;
+    size_t uniqueHooks = 2;
+    size_t states = 1;
+    size_t scripts = 1;
+    double logRate = 0.01;
+    size_t frames = 1000;
+    std::filesystem::path csv;
+};
+
+std::optional<Options> ParseOptions(int aArgc, char** aArgv)
+{
+    Options options;
+    for (auto i = 1; i < aArgc; i++)
+    {
+        std::string_view arg = aArgv[i];
+        if (i + 1 >= aArgc)
+        {
+            return std::nullopt;
+        }
+
+        std::string_view value = aArgv[++i];
+        auto number = [&value]() { return std::strtoull(value.data(), nullptr, 10); };
+
+        if (arg == "--counts")
+        {
+            options.counts.clear();
+            for (const auto part : std::views::split(value, ','))
+            {
+                options.counts.push_back(std::strtoull(std::string(part.begin(), part.end()).c_str(), nullptr, 10));
+            }
+        }
+        else if (arg == "--shared-hooks")
+        {
+            options.sharedHooks = number();
+        }
+        else if (arg == "--unique-hooks")
+        {
+            options.uniqueHooks = number();
+        }
+        else if (arg == "--states")
+        {
+            options.states = number();
+        }
+        else if (arg == "--scripts")
+        {
+            options.scripts = number();
+        }
+        else if (arg == "--log-rate")
+        {
+            options.logRate = std::strtod(value.data(), nullptr);
+        }
+        else if (arg == "--frames")
+        {
+            options.frames = number();
+        }
+        else if (arg == "--csv")
+        {
+            options.csv = value;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (options.counts.empty() || options.frames == 0)
+    {
+        return std::nullopt;
+    }
+
+    return options;
+}
+
+double GetResidentMb()
+{
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+        KERN_SUCCESS)
+    {
+        return 0;
+    }
+
+    return static_cast<double>(info.resident_size) / (1024 * 1024);
+}
+
+int RunChild(size_t aFrames)
+{
+    using namespace std::chrono;
+
+    auto report = Harness::OpenReport();
+    const auto residentBefore = GetResidentMb();
+
+    const auto loadStart = steady_clock::now();
+
+    App::Construct();
+    auto app = App::Get();
+    app->Startup();
+
+    const duration<double, std::milli> loadElapsed = steady_clock::now() - loadStart;
+    Harness::Report(report, "load_ms", loadElapsed.count());
+    Harness::Report(report, "memory_mb", GetResidentMb() - residentBefore);
+    Harness::Report(report, "hooks_requested", static_cast<double>(HookTargets::GetRequestedHooks()));
+    Harness::Report(report, "hooks_attached", static_cast<double>(HookTargets::GetAttachedHooks()));
+
+    auto stateSystem = app->GetStateSystem();
+    stateSystem->OnEnter(RED4ext::EGameStateType::Running, nullptr);
+
+    // A frame is a call through every hooked target and the state update RED4ext runs every frame.
+    std::vector<double> frames;
+    frames.reserve(aFrames);
+
+    const auto detourCallsBefore = HookTargets::GetDetourCalls();
+
+    auto value = 0;
+    for (size_t i = 0; i < aFrames; i++)
+    {
+        const auto frameStart = steady_clock::now();
+
+        for (auto fn : HookTargets::GetHandedOut())
+        {
+            value = fn(value);
+        }
+
+        stateSystem->OnUpdate(RED4ext::EGameStateType::Running, nullptr);
+
+        const duration<double, std::micro> frameElapsed = steady_clock::now() - frameStart;
+        frames.push_back(frameElapsed.count());
+    }
+
+    // Zero in Frida Gadget mode, the frame cost then does not include the hooks.
+    Harness::Report(report, "detour_calls", static_cast<double>(HookTargets::GetDetourCalls() - detourCallsBefore));
+
+    std::ranges::sort(frames);
+    Harness::Report(report, "frame_us", frames[frames.size() / 2]);
+    Harness::Report(report, "frame_p99_us", frames[frames.size() * 99 / 100]);
+
+    stateSystem->OnExit(RED4ext::EGameStateType::Running, nullptr);
+
+    app->Shutdown();
+    App::Destruct();
+
+    if (report)
+    {
+        std::fclose(report);
+    }
+
+    asm volatile("" : : "r"(value));
+    return 0;
+}
+
+void CreateScripts(const Harness::Layout& aLayout, size_t aScripts)
+{
+    for (const auto& entry : std::filesystem::directory_iterator(aLayout.plugins))
+    {
+        auto dir = entry.path() / "scripts";
+        std::filesystem::create_directories(dir);
+
+        for (size_t i = 0; i < aScripts; i++)
+        {
+            std::ofstream script(dir / fmt::format("{}.reds", i));
+            script << fmt::format("public func Synthetic{}() -> Int32 {{ return {}; }}\n", i, i);
+        }
+    }
+}
+} // namespace
+
+int main(int aArgc, char** aArgv)
+{
+    if (aArgc == 3 && std::string_view(aArgv[1]) == "--child")
+    {
+        return RunChild(std::strtoull(aArgv[2], nullptr, 10));
+    }
+
+    auto options = ParseOptions(aArgc, aArgv);
+    if (!options)
+    {
+        fmt::print(stderr,
+                   "Usage: {} [--counts 0,10,...] [--shared-hooks N] [--unique-hooks N] [--states N] [--scripts N] "
+                   "[--log-rate X] [--frames N] [--csv FILE]\n",
+                   aArgv[0]);
+        return 2;
+    }
+
+    const auto self = std::filesystem::absolute(aArgv[0]);
+    const auto plugin = self.parent_path() / (std::string(PluginName) + Harness::PluginExtension);
+
+    const auto config = fmt::format("shared_hooks={}\nunique_hooks={}\nstates={}\nscripts={}\nlog_rate={}\n",
+                                    options->sharedHooks, options->uniqueHooks, options->states, options->scripts,
+                                    options->logRate);
+
+    const auto root = std::filesystem::temp_directory_path() / fmt::format("red4ext-scaling-{}", getpid());
+    std::filesystem::remove_all(root);
+
+    std::ofstream csv;
+    if (!options->csv.empty())
+    {
+        csv.open(options->csv);
+        csv << "plugins,load_ms,frame_us,frame_p99_us,memory_mb,hooks_requested,hooks_attached,detour_calls\n";
+    }
+
+    fmt::print("{:>7} {:>10} {:>10} {:>10} {:>10} {:>12}\n", "plugins", "load ms", "frame us", "p99 us", "memory MB",
+               "hooks");
+
+    auto isComplete = true;
+    auto isUnpatched = false;
+    for (auto count : options->counts)
+    {
+        auto layout = Harness::CreateLayout(root / std::to_string(count), self, false);
+        Harness::InstallPlugins(layout, plugin, count, config);
+        CreateScripts(layout, options->scripts);
+
+        auto result = Harness::Run(layout.exe, {"--child", std::to_string(options->frames)});
+        if (!result)
+        {
+            isComplete = false;
+            break;
+        }
+
+        auto& values = result->values;
+        isUnpatched |= values["hooks_attached"] > 0 && values["detour_calls"] == 0;
+
+        fmt::print("{:>7} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>5}/{:<6}\n", count, values["load_ms"],
+                   values["frame_us"], values["frame_p99_us"], values["memory_mb"], values["hooks_attached"],
+                   values["hooks_requested"]);
+
+        if (csv.is_open())
+        {
+            csv << fmt::format("{},{},{},{},{},{},{},{}\n", count, values["load_ms"], values["frame_us"],
+                               values["frame_p99_us"], values["memory_mb"], values["hooks_requested"],
+                               values["hooks_attached"], values["detour_calls"]);
+        }
+    }
+
+    if (isUnpatched)
+    {
+        fmt::print("\nThe hooks were attached but no detour ran (was RED4ext built in Frida Gadget mode?), the frame cost "
+                   "does not include them.\n");
+    }
+
+    std::filesystem::remove_all(root);
+    return isComplete ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+#include <RED4ext/RED4ext.hpp>
+
+#include "HookTargets.hpp"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <utility>
+
+/*
+ * Synthetic plugin the benchmarks copy into the plugins directory. Every copy reads '<name>.ini' next to itself, the
+ * defaults apply when the file does not exist:
+ *
+ *  shared_hooks = 0   - hooks on the targets all copies share.
+ *  unique_hooks = 1   - hooks on targets no other hook uses.
+ *  states       = 0   - 'Running' state callbacks.
+ *  scripts      = 0   - script paths, '<plugin dir>/scripts/<index>.reds'.
+ *  log_rate     = 0   - messages logged per frame, fractions log every few frames.
+ *
+ * The hook targets are exported by the process that loads RED4ext (see 'HookTargets.hpp').
+ */
+namespace
+{
+using Target_t = int (*)(int);
+using SharedTarget_t = void* (*)(uint32_t);
+using NextTarget_t = void* (*)();
+using ReportHook_t = void (*)(bool);
+
+constexpr size_t MaxHooks = 64;
+
+struct Settings
+{
+    size_t sharedHooks = 0;
+    size_t uniqueHooks = 1;
+    size_t states = 0;
+    size_t scripts = 0;
+    double logRate = 0;
+};
+
+std::filesystem::path g_path;
+std::wstring g_name;
+
+Settings g_settings;
+RED4ext::PluginHandle g_handle = nullptr;
+const RED4ext::Sdk* g_sdk = nullptr;
+double g_pendingLogs = 0;
+
+std::array<Target_t, MaxHooks> g_originals{};
+
+// Points at the host's 'RED4extBenchmark_DetourCalls' once the hooks are attached.
+uint64_t g_unreportedCalls = 0;
+uint64_t* g_detourCalls = &g_unreportedCalls;
+
+// Every hook needs its own detour to know which original to call.
+template<size_t N>
+int Detour(int aValue)
+{
+    ++*g_detourCalls;
+    return g_originals[N](aValue);
+}
+
+template<size_t... I>
+constexpr std::array<Target_t, sizeof...(I)> MakeDetours(std::index_sequence<I...>)
+{
+    return {&Detour<I>...};
+}
+
+constexpr auto Detours = MakeDetours(std::make_index_sequence<MaxHooks>());
+
+Settings ReadSettings(const std::filesystem::path& aPath)
+{
+    Settings settings;
+
+    std::ifstream file(aPath);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        auto separator = line.find('=');
+        if (separator == std::string::npos)
+        {
+            continue;
+        }
+
+        auto key = line.substr(0, separator);
+        auto value = line.substr(separator + 1);
+
+        if (key == "shared_hooks")
+        {
+            settings.sharedHooks = std::stoul(value);
+        }
+        else if (key == "unique_hooks")
+        {
+            settings.uniqueHooks = std::stoul(value);
+        }
+        else if (key == "states")
+        {
+            settings.states = std::stoul(value);
+        }
+        else if (key == "scripts")
+        {
+            settings.scripts = std::stoul(value);
+        }
+        else if (key == "log_rate")
+        {
+            settings.logRate = std::stod(value);
+        }
+    }
+
+    return settings;
+}
+
+void AttachHooks()
+{
+    auto sharedTarget = reinterpret_cast<SharedTarget_t>(dlsym(RTLD_DEFAULT, "RED4extBenchmark_SharedTarget"));
+    auto nextTarget = reinterpret_cast<NextTarget_t>(dlsym(RTLD_DEFAULT, "RED4extBenchmark_NextTarget"));
+    auto reportHook = reinterpret_cast<ReportHook_t>(dlsym(RTLD_DEFAULT, "RED4extBenchmark_ReportHook"));
+
+    if (!sharedTarget || !nextTarget)
+    {
+        return;
+    }
+
+    if (auto detourCalls = static_cast<uint64_t*>(dlsym(RTLD_DEFAULT, "RED4extBenchmark_DetourCalls")))
+    {
+        g_detourCalls = detourCalls;
+    }
+
+    const auto count = std::min(g_settings.sharedHooks + g_settings.uniqueHooks, MaxHooks);
+    for (size_t i = 0; i < count; i++)
+    {
+        // Spread the shared hooks over the shared targets, starting at a different one for every copy.
+        auto shared = (std::hash<std::wstring>{}(g_name) + i) % HookTargets::SharedCount;
+        auto target = i < g_settings.sharedHooks ? sharedTarget(static_cast<uint32_t>(shared)) : nextTarget();
+
+        auto isAttached = target && g_sdk->hooking->Attach(g_handle, target, reinterpret_cast<void*>(Detours[i]),
+                                                           reinterpret_cast<void**>(&g_originals[i]));
+        if (reportHook)
+        {
+            reportHook(isAttached);
+        }
+    }
+}
+
+bool OnRunningEnter(RED4ext::CGameApplication*)
+{
+    return true;
+}
+
+bool OnRunningUpdate(RED4ext::CGameApplication*)
+{
+    g_pendingLogs += g_settings.logRate;
+    while (g_pendingLogs >= 1)
+    {
+        g_sdk->logger->Info(g_handle, "Synthetic update");
+        g_pendingLogs -= 1;
+    }
+
+    // Returning false keeps the callback registered for the next frame.
+    return false;
+}
+
+bool OnRunningExit(RED4ext::CGameApplication*)
+{
+    return true;
+}
+} // namespace
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL Main(RED4ext::PluginHandle aHandle, RED4ext::EMainReason aReason,
+                                        const RED4ext::Sdk* aSdk)
+{
+    switch (aReason)
+    {
+    case RED4ext::EMainReason::Load:
+    {
+        g_handle = aHandle;
+        g_sdk = aSdk;
+
+        auto configPath = g_path;
+        g_settings = ReadSettings(configPath.replace_extension(".ini"));
+
+        AttachHooks();
+
+        static RED4ext::GameState state{&OnRunningEnter, &OnRunningUpdate, &OnRunningExit};
+        for (size_t i = 0; i < g_settings.states; i++)
+        {
+            aSdk->gameStates->Add(aHandle, RED4ext::EGameStateType::Running, &state);
+        }
+
+        for (size_t i = 0; i < g_settings.scripts; i++)
+        {
+            auto script = (g_path.parent_path() / L"scripts" / (std::to_wstring(i) + L".reds")).wstring();
+            aSdk->scripts->Add(aHandle, script.c_str());
+        }
+
+        break;
+    }
+    case RED4ext::EMainReason::Unload:
+    {
+        break;
+    }
+    }
+
+    return true;
+}
+
+RED4EXT_C_EXPORT void RED4EXT_CALL Query(RED4ext::PluginInfo* aInfo)
+{
+    // Every copy needs a distinct name, take it from the file the copy was loaded from.
+    Dl_info info{};
+    if (dladdr(reinterpret_cast<void*>(&Query), &info) && info.dli_fname)
+    {
+        g_path = info.dli_fname;
+        g_name = g_path.stem().wstring();
+    }
+    else
+    {
+        g_name = L"RED4ext.Benchmarks.Plugin";
+    }
+
+    aInfo->name = g_name.c_str();
+    aInfo->author = L"RED4ext";
+    aInfo->version = RED4EXT_SEMVER(1, 0, 0);
+    aInfo->runtime = RED4EXT_RUNTIME_INDEPENDENT;
+    aInfo->sdk = RED4EXT_SDK_LATEST;
+}
+
+RED4EXT_C_EXPORT uint32_t RED4EXT_CALL Supports()
+{
+    return RED4EXT_API_VERSION_LATEST;
+}
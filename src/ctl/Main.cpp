@@ -0,0 +1,252 @@
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*
+ * Client of the control server RED4ext runs in the game ('ControlSystem'). It sends one request and prints the
+ * response, the exit code is 0 for 'OK', 1 for 'ERR' and 2 when the server cannot be reached.
+ *
+ * Without '--pid' or '--socket' it connects to the only game that is running, the sockets are found by their name,
+ * 'red4ext-<pid>.sock' in the temporary directory.
+ */
+namespace
+{
+constexpr auto SocketPrefix = "red4ext-";
+constexpr auto SocketExtension = ".sock";
+
+struct Options
+{
+    std::filesystem::path socket;
+    std::string request;
+};
+
+void PrintUsage(const char* aName)
+{
+    fmt::print(stderr,
+               "Usage: {} [--pid PID | --socket PATH] <command> [arguments...]\n"
+               "\n"
+               "Commands (run 'help' for the ones the game supports):\n"
+               "  plugins, hooks, metrics [prefix], locks, log <logger> <level|default>, instrument <on|off>,\n"
+               "  diagnostics <on|off> [hooks], trace <seconds>, profile <seconds>\n",
+               aName);
+}
+
+std::filesystem::path GetSocketDir()
+{
+    std::error_code error;
+    auto dir = std::filesystem::temp_directory_path(error);
+
+    return error ? std::filesystem::path("/tmp") : dir;
+}
+
+std::filesystem::path GetSocketPath(pid_t aPid)
+{
+    return GetSocketDir() / fmt::format("{}{}{}", SocketPrefix, aPid, SocketExtension);
+}
+
+// Returns the process ids of the games with a control socket, skipping the sockets left by processes that died.
+std::vector<pid_t> FindGames()
+{
+    std::vector<pid_t> pids;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(GetSocketDir(), error))
+    {
+        const auto name = entry.path().filename().string();
+        if (!name.starts_with(SocketPrefix) || !name.ends_with(SocketExtension))
+        {
+            continue;
+        }
+
+        const auto pid = static_cast<pid_t>(std::strtol(name.c_str() + std::strlen(SocketPrefix), nullptr, 10));
+        if (pid > 0 && (kill(pid, 0) == 0 || errno == EPERM))
+        {
+            pids.push_back(pid);
+        }
+    }
+
+    return pids;
+}
+
+std::optional<Options> ParseOptions(int aArgc, char** aArgv)
+{
+    Options options;
+
+    auto i = 1;
+    for (; i < aArgc; i++)
+    {
+        std::string_view arg = aArgv[i];
+        if (!arg.starts_with("--"))
+        {
+            break;
+        }
+
+        if (i + 1 >= aArgc)
+        {
+            return std::nullopt;
+        }
+
+        std::string_view value = aArgv[++i];
+        if (arg == "--pid")
+        {
+            options.socket = GetSocketPath(static_cast<pid_t>(std::strtol(value.data(), nullptr, 10)));
+        }
+        else if (arg == "--socket")
+        {
+            options.socket = value;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (i == aArgc)
+    {
+        return std::nullopt;
+    }
+
+    for (; i < aArgc; i++)
+    {
+        if (!options.request.empty())
+        {
+            options.request += ' ';
+        }
+
+        options.request += aArgv[i];
+    }
+
+    options.request += '\n';
+    return options;
+}
+
+int Connect(const std::filesystem::path& aPath)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    const auto path = aPath.string();
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        fmt::print(stderr, "The socket path '{}' is too long\n", path);
+        return -1;
+    }
+
+    path.copy(address.sun_path, path.size());
+
+    auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        fmt::print(stderr, "Could not connect to '{}': {}\n", path, std::strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+} // namespace
+
+int main(int aArgc, char** aArgv)
+{
+    auto options = ParseOptions(aArgc, aArgv);
+    if (!options)
+    {
+        PrintUsage(aArgv[0]);
+        return 2;
+    }
+
+    if (options->socket.empty())
+    {
+        auto pids = FindGames();
+        if (pids.size() != 1)
+        {
+            fmt::print(stderr, "{}, use '--pid' or '--socket'\n",
+                       pids.empty() ? "No running game has a control socket"
+                                    : fmt::format("Several games are running ({})", fmt::join(pids, ", ")));
+            return 2;
+        }
+
+        options->socket = GetSocketPath(pids.front());
+    }
+
+    // The server closing the connection is reported by 'recv', not by a signal.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    auto fd = Connect(options->socket);
+    if (fd < 0)
+    {
+        return 2;
+    }
+
+    std::string_view request = options->request;
+    while (!request.empty())
+    {
+        auto count = send(fd, request.data(), request.size(), 0);
+        if (count <= 0)
+        {
+            fmt::print(stderr, "Could not send the request: {}\n", std::strerror(errno));
+            close(fd);
+            return 2;
+        }
+
+        request.remove_prefix(static_cast<size_t>(count));
+    }
+
+    std::string buffer;
+    char chunk[4096];
+
+    while (true)
+    {
+        auto end = buffer.find('\n');
+        if (end == std::string::npos)
+        {
+            auto count = recv(fd, chunk, sizeof(chunk), 0);
+            if (count <= 0)
+            {
+                fmt::print(stderr, "The connection was closed before the response was complete\n");
+                close(fd);
+                return 2;
+            }
+
+            buffer.append(chunk, static_cast<size_t>(count));
+            continue;
+        }
+
+        std::string_view line(buffer.data(), end);
+        if (line == "OK")
+        {
+            close(fd);
+            return 0;
+        }
+
+        if (line.starts_with("ERR "))
+        {
+            line.remove_prefix(4);
+            fmt::print(stderr, "error: {}\n", line);
+
+            close(fd);
+            return 1;
+        }
+
+        fmt::print("{}\n", line);
+        buffer.erase(0, end + 1);
+    }
+}
@@ -89,6 +89,14 @@ std::uintptr_t Addresses::Resolve(std::uint32_t aHash) const
 #endif
 }
 
+void Addresses::Resolve(std::span<const std::uint32_t> aHashes, std::span<std::uintptr_t> aAddresses) const
+{
+    for (size_t i = 0; i < aHashes.size(); i++)
+    {
+        aAddresses[i] = Resolve(aHashes[i]);
+    }
+}
+
 void Addresses::LoadSymbols(const std::filesystem::path& aSymbolsPath)
 {
     // Map RED4ext hashes to macOS mangled symbols
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <span>
 #include <unordered_map>
 
 #include "Paths.hpp"
@@ -16,6 +17,9 @@ public:
 
     std::uintptr_t Resolve(std::uint32_t aHash) const;
 
+    // Resolves every hash into the matching slot of 'aAddresses', unknown hashes are resolved to zero.
+    void Resolve(std::span<const std::uint32_t> aHashes, std::span<std::uintptr_t> aAddresses) const;
+
 private:
     Addresses(const Paths& aPaths);
 
@@ -1,21 +1,11 @@
 #include "App.hpp"
 #include "Addresses.hpp"
-#include "DetourTransaction.hpp"
+#include "Hooks/HookTable.hpp"
 #include "Image.hpp"
 #include "Platform.hpp"
 #include "Utils.hpp"
 #include "Version.hpp"
 
-#include "Hooks/AssertionFailed.hpp"
-#include "Hooks/CGameApplication.hpp"
-#include "Hooks/CollectSaveableSystems.hpp"
-#include "Hooks/ExecuteProcess.hpp"
-#include "Hooks/InitScripts.hpp"
-#include "Hooks/LoadScripts.hpp"
-#include "Hooks/Main_Hooks.hpp"
-#include "Hooks/ValidateScripts.hpp"
-#include "Hooks/gsmState_SessionActive.hpp"
-
 namespace
 {
 std::unique_ptr<App> g_app;
@@ -34,32 +24,43 @@ App::App()
     }
 
     AddSystem<LoggerSystem>(m_paths, m_config, m_devConsole);
+    AddSystem<MetricsSystem>();
+    AddSystem<AllocatorSystem>();
+    AddSystem<IoSystem>(m_paths);
+    AddSystem<CacheSystem>(m_config.GetCache(), m_paths);
+    AddSystem<ConfigSystem>(m_config, m_paths);
+    AddSystem<EventSystem>();
+    AddSystem<SnapshotSystem>();
     AddSystem<ScriptCompilationSystem>(m_paths);
     AddSystem<HookingSystem>();
     AddSystem<StateSystem>();
     AddSystem<PluginSystem>(m_config.GetPlugins(), m_paths);
+    AddSystem<ControlSystem>(m_config.GetDev());
 
     m_systems.shrink_to_fit();
 
-    const auto filename = fmt::format(L"red4ext-{}.log", Utils::FormatCurrentTimestamp());
+    const auto filename = fmt::format("red4ext-{}.log", Utils::FormatCurrentTimestamp());
 
-    auto logger = Utils::CreateLogger(L"RED4ext", filename, m_paths, m_config, m_devConsole);
+    auto logger = Utils::CreateLogger("RED4ext", filename, m_paths, m_config, m_devConsole);
     spdlog::set_default_logger(logger);
 
     Log::info("RED4ext (v{}) is initializing...", RED4EXT_VERSION_STR);
 
     Log::debug("Using the following paths:");
-    Log::debug(L"  Root: {}", m_paths.GetRootDir());
-    Log::debug(L"  RED4ext: {}", m_paths.GetRED4extDir());
-    Log::debug(L"  Logs: {}", m_paths.GetLogsDir());
-    Log::debug(L"  Config: {}", m_paths.GetConfigFile());
-    Log::debug(L"  Plugins: {}", m_paths.GetPluginsDir());
+    Log::debug("  Root: {}", m_paths.GetRootDir());
+    Log::debug("  RED4ext: {}", m_paths.GetRED4extDir());
+    Log::debug("  Logs: {}", m_paths.GetLogsDir());
+    Log::debug("  Config: {}", m_paths.GetConfigFile());
+    Log::debug("  Plugins: {}", m_paths.GetPluginsDir());
+    Log::debug("  Cache: {}", m_paths.GetCacheDir());
 
     Log::debug("Using the following configuration:");
     Log::debug("  version: {}", m_config.GetVersion());
 
     const auto& dev = m_config.GetDev();
     Log::debug("  dev.console: {}", dev.hasConsole);
+    Log::debug("  dev.control_socket: {}", dev.hasControlSocket);
+    Log::debug("  dev.diagnostic_hooks: [ {} ]", fmt::join(dev.diagnosticHooks, ", "));
 
     const auto& loggingConfig = m_config.GetLogging();
     Log::debug("  logging.level: {}", spdlog::level::to_string_view(loggingConfig.level));
@@ -69,6 +70,8 @@ App::App()
 
     const auto& pluginsConfig = m_config.GetPlugins();
     Log::debug("  plugins.enabled: {}", pluginsConfig.isEnabled);
+    Log::debug("  plugins.heap_accounting: {}", pluginsConfig.isHeapAccountingEnabled);
+    Log::debug("  plugins.update_budget_us: {}", pluginsConfig.updateBudget);
 
     const auto& ignored = pluginsConfig.ignored;
     if (ignored.empty())
@@ -77,19 +80,11 @@ App::App()
     }
     else
     {
-#ifdef RED4EXT_PLATFORM_MACOS
-        // On macOS, convert wstrings to strings for logging
-        std::vector<std::string> ignoredNarrow;
-        for (const auto& ws : ignored)
-        {
-            ignoredNarrow.push_back(Log::Narrow(ws));
-        }
-        Log::debug("  plugins.ignored: [ {} ]", fmt::join(ignoredNarrow, ", "));
-#else
-        Log::debug(L"  plugins.ignored: [ {} ]", fmt::join(ignored, L", "));
-#endif
+        Log::debug("  plugins.ignored: [ {} ]", fmt::join(ignored, ", "));
     }
 
+    Log::debug("  cache.max_size: {} MB", m_config.GetCache().maxSize);
+
     Log::debug("Base address is: {}", reinterpret_cast<void*>(Platform::GetModuleHandle(nullptr)));
 
     const auto image = Image::Get();
@@ -114,6 +109,7 @@ App::App()
 #endif
 
     Addresses::Construct(m_paths);
+    Hooks::Publish(*GetMetricsSystem());
 
     if (AttachHooks())
     {
@@ -139,25 +135,7 @@ void App::Destruct()
 
     Log::trace("Detaching the hooks...");
 
-    DetourTransaction transaction;
-    if (transaction.IsValid())
-    {
-#ifdef RED4EXT_PLATFORM_MACOS
-        auto success = Hooks::CGameApplication::Detach() && Hooks::ExecuteProcess::Detach() &&
-                       Hooks::InitScripts::Detach() && Hooks::LoadScripts::Detach() &&
-                       Hooks::ValidateScripts::Detach() && Hooks::AssertionFailed::Detach() &&
-                       Hooks::gsmState_SessionActive::Detach();
-#else
-        auto success = Hooks::CGameApplication::Detach() && Hooks::Main::Detach() && Hooks::ExecuteProcess::Detach() &&
-                       Hooks::InitScripts::Detach() && Hooks::LoadScripts::Detach() &&
-                       Hooks::ValidateScripts::Detach() && Hooks::AssertionFailed::Detach() &&
-                       Hooks::gsmState_SessionActive::Detach();
-#endif
-        if (success)
-        {
-            transaction.Commit();
-        }
-    }
+    Hooks::Detach();
 
     g_app.reset(nullptr);
     Log::info("RED4ext has been terminated");
@@ -208,6 +186,48 @@ LoggerSystem* App::GetLoggerSystem()
     return static_cast<LoggerSystem*>(system.get());
 }
 
+MetricsSystem* App::GetMetricsSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Metrics));
+    return static_cast<MetricsSystem*>(system.get());
+}
+
+AllocatorSystem* App::GetAllocatorSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Allocator));
+    return static_cast<AllocatorSystem*>(system.get());
+}
+
+IoSystem* App::GetIoSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Io));
+    return static_cast<IoSystem*>(system.get());
+}
+
+CacheSystem* App::GetCacheSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Cache));
+    return static_cast<CacheSystem*>(system.get());
+}
+
+ConfigSystem* App::GetConfigSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Config));
+    return static_cast<ConfigSystem*>(system.get());
+}
+
+EventSystem* App::GetEventSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Event));
+    return static_cast<EventSystem*>(system.get());
+}
+
+SnapshotSystem* App::GetSnapshotSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Snapshot));
+    return static_cast<SnapshotSystem*>(system.get());
+}
+
 HookingSystem* App::GetHookingSystem()
 {
     auto& system = m_systems.at(static_cast<size_t>(ESystemType::Hooking));
@@ -232,6 +252,12 @@ ScriptCompilationSystem* App::GetScriptCompilationSystem()
     return static_cast<ScriptCompilationSystem*>(system.get());
 }
 
+ControlSystem* App::GetControlSystem()
+{
+    auto& system = m_systems.at(static_cast<size_t>(ESystemType::Control));
+    return static_cast<ControlSystem*>(system.get());
+}
+
 const Paths* App::GetPaths() const
 {
     return &m_paths;
@@ -239,62 +265,5 @@ const Paths* App::GetPaths() const
 
 bool App::AttachHooks() const
 {
-    Log::trace("Attaching hooks...");
-
-    DetourTransaction transaction;
-    if (!transaction.IsValid())
-    {
-        return false;
-    }
-
-#ifdef RED4EXT_PLATFORM_MACOS
-    // On macOS, we can't patch code on signed binaries due to code signing enforcement.
-    // Try each hook individually and continue even if some fail.
-    // This allows RED4ext to run in a degraded mode where some hooks may not be active.
-    
-    int successCount = 0;
-    int totalHooks = 8;
-    
-    if (Hooks::CGameApplication::Attach()) successCount++; 
-    else Log::warn("CGameApplication hook failed - state management may be limited");
-    
-    if (Hooks::ExecuteProcess::Attach()) successCount++;
-    else Log::warn("ExecuteProcess hook failed - script compilation redirection unavailable");
-    
-    if (Hooks::InitScripts::Attach()) successCount++;
-    else Log::warn("InitScripts hook failed - script initialization hooks unavailable");
-    
-    if (Hooks::LoadScripts::Attach()) successCount++;
-    else Log::warn("LoadScripts hook failed - script loading hooks unavailable");
-    
-    if (Hooks::ValidateScripts::Attach()) successCount++;
-    else Log::warn("ValidateScripts hook failed - script validation hooks unavailable");
-    
-    if (Hooks::AssertionFailed::Attach()) successCount++;
-    else Log::warn("AssertionFailed hook failed - assertion logging unavailable");
-    
-    if (Hooks::CollectSaveableSystems::Attach()) successCount++;
-    else Log::warn("CollectSaveableSystems hook failed - save system hooks unavailable");
-    
-    if (Hooks::gsmState_SessionActive::Attach()) successCount++;
-    else Log::warn("gsmState_SessionActive hook failed - session state hooks unavailable");
-    
-    Log::info("Attached {}/{} hooks successfully", successCount, totalHooks);
-    
-    // On macOS, we consider initialization successful even with partial hooks
-    // Plugin loading and basic functionality should still work
-    transaction.Commit();
-    return true;
-#else
-    auto success = Hooks::Main::Attach() && Hooks::CGameApplication::Attach() && Hooks::ExecuteProcess::Attach() &&
-                   Hooks::InitScripts::Attach() && Hooks::LoadScripts::Attach() && Hooks::ValidateScripts::Attach() &&
-                   Hooks::AssertionFailed::Attach() && Hooks::CollectSaveableSystems::Attach() &&
-                   Hooks::gsmState_SessionActive::Attach();
-    if (success)
-    {
-        return transaction.Commit();
-    }
-
-    return false;
-#endif
+    return Hooks::Attach(m_config.GetDev().diagnosticHooks);
 }
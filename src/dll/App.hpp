@@ -3,10 +3,18 @@
 #include "Config.hpp"
 #include "DevConsole.hpp"
 #include "Paths.hpp"
+#include "Systems/AllocatorSystem.hpp"
+#include "Systems/CacheSystem.hpp"
+#include "Systems/ConfigSystem.hpp"
+#include "Systems/ControlSystem.hpp"
+#include "Systems/EventSystem.hpp"
 #include "Systems/HookingSystem.hpp"
+#include "Systems/IoSystem.hpp"
 #include "Systems/LoggerSystem.hpp"
+#include "Systems/MetricsSystem.hpp"
 #include "Systems/PluginSystem.hpp"
 #include "Systems/ScriptCompilationSystem.hpp"
+#include "Systems/SnapshotSystem.hpp"
 #include "Systems/StateSystem.hpp"
 
 class App
@@ -22,10 +30,18 @@ public:
     void Shutdown();
 
     LoggerSystem* GetLoggerSystem();
+    MetricsSystem* GetMetricsSystem();
+    AllocatorSystem* GetAllocatorSystem();
+    IoSystem* GetIoSystem();
+    CacheSystem* GetCacheSystem();
+    ConfigSystem* GetConfigSystem();
+    EventSystem* GetEventSystem();
+    SnapshotSystem* GetSnapshotSystem();
     HookingSystem* GetHookingSystem();
     StateSystem* GetStateSystem();
     PluginSystem* GetPluginSystem();
     ScriptCompilationSystem* GetScriptCompilationSystem();
+    ControlSystem* GetControlSystem();
 
     const Paths* GetPaths() const;
 
@@ -9,6 +9,7 @@ Config::Config(const Paths& aPaths)
     , m_dev()
     , m_logging()
     , m_plugins()
+    , m_cache()
 {
     const auto file = aPaths.GetConfigFile();
 
@@ -52,6 +53,11 @@ const Config::PluginsConfig& Config::GetPlugins() const
     return m_plugins;
 }
 
+const Config::CacheConfig& Config::GetCache() const
+{
+    return m_cache;
+}
+
 void Config::Load(const std::filesystem::path& aFile)
 {
     try
@@ -107,8 +113,15 @@ void Config::Save(const std::filesystem::path& aFile)
                                    {"max_files", m_logging.maxFiles},
                                    {"max_file_size", m_logging.maxFileSize}}},
 
-            {"plugins", value_type{{"enabled", m_plugins.isEnabled}, {"ignored", std::vector<std::string>{}}}},
-            {"dev", value_type{{"console", m_dev.hasConsole}, {"wait_for_debugger", m_dev.waitForDebugger}}}};
+            {"plugins", value_type{{"enabled", m_plugins.isEnabled},
+                                   {"heap_accounting", m_plugins.isHeapAccountingEnabled},
+                                   {"update_budget_us", m_plugins.updateBudget},
+                                   {"ignored", std::vector<std::string>{}}}},
+            {"cache", value_type{{"max_size", m_cache.maxSize}}},
+            {"dev", value_type{{"console", m_dev.hasConsole},
+                               {"wait_for_debugger", m_dev.waitForDebugger},
+                               {"control_socket", m_dev.hasControlSocket},
+                               {"diagnostic_hooks", m_dev.diagnosticHooks}}}};
 
         config.comments().push_back(
             " See https://docs.red4ext.com/getting-started/configuration for more options or information.");
@@ -133,12 +146,15 @@ void Config::LoadV0(const toml::value& aConfig)
     m_dev.LoadV0(aConfig);
     m_logging.LoadV0(aConfig);
     m_plugins.LoadV0(aConfig);
+    m_cache.LoadV0(aConfig);
 }
 
 void Config::DevConfig::LoadV0(const toml::value& aConfig)
 {
     hasConsole = toml::find_or(aConfig, "dev", "console", hasConsole);
     waitForDebugger = toml::find_or(aConfig, "dev", "wait_for_debugger", waitForDebugger);
+    hasControlSocket = toml::find_or(aConfig, "dev", "control_socket", hasControlSocket);
+    diagnosticHooks = toml::find_or(aConfig, "dev", "diagnostic_hooks", diagnosticHooks);
 }
 
 void Config::LoggingConfig::LoadV0(const toml::value& aConfig)
@@ -188,16 +204,16 @@ void Config::LoggingConfig::LoadV0(const toml::value& aConfig)
 void Config::PluginsConfig::LoadV0(const toml::value& aConfig)
 {
     isEnabled = toml::find_or(aConfig, "plugins", "enabled", isEnabled);
+    isHeapAccountingEnabled = toml::find_or(aConfig, "plugins", "heap_accounting", isHeapAccountingEnabled);
+    updateBudget = toml::find_or(aConfig, "plugins", "update_budget_us", updateBudget);
 
     std::vector<std::string> ignoredPlugins;
     ignoredPlugins = toml::find_or(aConfig, "plugins", "ignored", ignoredPlugins);
 
-    for (const auto& plugin : ignoredPlugins)
-    {
-#ifdef RED4EXT_PLATFORM_MACOS
-        ignored.emplace(Utils::Widen(plugin));
-#else
-        ignored.emplace(Utils::Widen(plugin));
-#endif
-    }
+    ignored.insert(ignoredPlugins.begin(), ignoredPlugins.end());
+}
+
+void Config::CacheConfig::LoadV0(const toml::value& aConfig)
+{
+    maxSize = toml::find_or(aConfig, "cache", "max_size", maxSize);
 }
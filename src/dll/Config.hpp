@@ -15,6 +15,10 @@ public:
 
         bool hasConsole = false;
         bool waitForDebugger = false;
+        bool hasControlSocket = true;
+
+        // Diagnostic built-in hooks to attach at startup, the others are only attached from the control socket.
+        std::vector<std::string> diagnosticHooks;
     };
 
     struct LoggingConfig
@@ -32,7 +36,16 @@ public:
         void LoadV0(const toml::value& aConfig);
 
         bool isEnabled = true;
-        std::unordered_set<std::wstring> ignored;
+        bool isHeapAccountingEnabled = false;
+        uint32_t updateBudget = 2000;
+        std::unordered_set<std::string> ignored;
+    };
+
+    struct CacheConfig
+    {
+        void LoadV0(const toml::value& aConfig);
+
+        uint32_t maxSize = 256;
     };
 
     Config(const Paths& aPaths);
@@ -43,6 +56,7 @@ public:
     const DevConfig& GetDev() const;
     const LoggingConfig& GetLogging() const;
     const PluginsConfig& GetPlugins() const;
+    const CacheConfig& GetCache() const;
 
 private:
     void Load(const std::filesystem::path& aFile);
@@ -55,4 +69,5 @@ private:
     DevConfig m_dev;
     LoggingConfig m_logging;
     PluginsConfig m_plugins;
+    CacheConfig m_cache;
 };
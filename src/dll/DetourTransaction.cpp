@@ -2,14 +2,15 @@
 #include "Utils.hpp"
 #include "Platform.hpp"
 
-#ifdef RED4EXT_PLATFORM_MACOS
-#include <mach/mach.h>
-#include <mach/thread_act.h>
-#include <mach/vm_map.h>
-#endif
+namespace
+{
+MetricsSystem::Metric s_pause;
+ProfiledMutex s_mutex("detours");
+} // namespace
 
 DetourTransaction::DetourTransaction(const std::source_location aSource)
     : m_source(aSource)
+    , m_lock(s_mutex.Lock(aSource))
     , m_state(State::Invalid)
 {
     Log::trace("Trying to start a detour transaction in '{}' ({}:{})", m_source.function_name(),
@@ -21,7 +22,9 @@ DetourTransaction::DetourTransaction(const std::source_location aSource)
         Log::trace("Transaction was started successfully", m_source.function_name(), m_source.file_name(),
                       m_source.line());
 
+#ifndef RED4EXT_PLATFORM_MACOS
         QueueThreadsForUpdate();
+#endif
         SetState(State::Started);
     }
     else
@@ -85,45 +88,7 @@ bool DetourTransaction::Commit()
         return false;
     }
 
-#ifdef RED4EXT_PLATFORM_MACOS
-    // Resume suspended threads
-    for (auto thread : m_threads)
-    {
-        thread_resume(thread);
-        mach_port_deallocate(mach_task_self(), thread);
-    }
-    
-    // Deallocate thread array and any threads we didn't suspend
-    if (m_threadArray)
-    {
-        thread_t selfThread = mach_thread_self();
-        for (mach_msg_type_number_t i = 0; i < m_threadCount; i++)
-        {
-            // Check if this thread was suspended (and already deallocated)
-            bool wasSuspended = false;
-            for (auto suspendedThread : m_threads)
-            {
-                if (m_threadArray[i] == suspendedThread)
-                {
-                    wasSuspended = true;
-                    break;
-                }
-            }
-            // Don't deallocate self thread or suspended threads (already done)
-            if (!wasSuspended && m_threadArray[i] != selfThread)
-            {
-                mach_port_deallocate(mach_task_self(), m_threadArray[i]);
-            }
-        }
-        mach_port_deallocate(mach_task_self(), selfThread);
-        vm_deallocate(mach_task_self(), reinterpret_cast<vm_address_t>(m_threadArray), 
-                     m_threadCount * sizeof(thread_t));
-        m_threadArray = nullptr;
-        m_threadCount = 0;
-    }
-    
-    m_threads.clear();
-#endif
+    RecordPause();
 
     SetState(State::Committed);
     Log::trace("The transaction was committed successfully");
@@ -174,45 +139,7 @@ bool DetourTransaction::Abort()
         return false;
     }
 
-#ifdef RED4EXT_PLATFORM_MACOS
-    // Resume suspended threads
-    for (auto thread : m_threads)
-    {
-        thread_resume(thread);
-        mach_port_deallocate(mach_task_self(), thread);
-    }
-    
-    // Deallocate thread array and any threads we didn't suspend
-    if (m_threadArray)
-    {
-        thread_t selfThread = mach_thread_self();
-        for (mach_msg_type_number_t i = 0; i < m_threadCount; i++)
-        {
-            // Check if this thread was suspended (and already deallocated)
-            bool wasSuspended = false;
-            for (auto suspendedThread : m_threads)
-            {
-                if (m_threadArray[i] == suspendedThread)
-                {
-                    wasSuspended = true;
-                    break;
-                }
-            }
-            // Don't deallocate self thread or suspended threads (already done)
-            if (!wasSuspended && m_threadArray[i] != selfThread)
-            {
-                mach_port_deallocate(mach_task_self(), m_threadArray[i]);
-            }
-        }
-        mach_port_deallocate(mach_task_self(), selfThread);
-        vm_deallocate(mach_task_self(), reinterpret_cast<vm_address_t>(m_threadArray), 
-                     m_threadCount * sizeof(thread_t));
-        m_threadArray = nullptr;
-        m_threadCount = 0;
-    }
-    
-    m_threads.clear();
-#endif
+    RecordPause();
 
     SetState(State::Aborted);
     Log::trace("The transaction was aborted successfully");
@@ -220,45 +147,13 @@ bool DetourTransaction::Abort()
     return true;
 }
 
+#ifndef RED4EXT_PLATFORM_MACOS
 void DetourTransaction::QueueThreadsForUpdate()
 {
     Log::trace("Queueing threads for detour update...");
 
-#ifdef RED4EXT_PLATFORM_MACOS
-    kern_return_t kr = task_threads(mach_task_self(), &m_threadArray, &m_threadCount);
-    if (kr != KERN_SUCCESS)
-    {
-        Log::warn("Could not retrieve task threads. Error code: {}", kr);
-        m_threadArray = nullptr;
-        m_threadCount = 0;
-        return;
-    }
+    m_suspendTime = std::chrono::steady_clock::now();
 
-    thread_t selfThread = mach_thread_self();
-    for (mach_msg_type_number_t i = 0; i < m_threadCount; i++)
-    {
-        if (m_threadArray[i] != selfThread)
-        {
-            if (thread_suspend(m_threadArray[i]) == KERN_SUCCESS)
-            {
-                m_threads.push_back(m_threadArray[i]);
-            }
-            else
-            {
-                Log::warn("Could not suspend thread {}.", m_threadArray[i]);
-                // Deallocate thread port we couldn't suspend
-                mach_port_deallocate(mach_task_self(), m_threadArray[i]);
-            }
-        }
-        else
-        {
-            // Don't store self thread, but also don't deallocate it yet
-        }
-    }
-    mach_port_deallocate(mach_task_self(), selfThread);
-
-    Log::trace("{} thread(s) queued for detour update (excl. current thread)", m_threads.size());
-#else
     wil::unique_tool_help_snapshot snapshot(CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0));
     if (!snapshot)
     {
@@ -325,7 +220,27 @@ void DetourTransaction::QueueThreadsForUpdate()
     } while (shouldContinue);
 
     Log::trace("{} thread(s) queued for detour update (excl. current thread)", m_handles.size());
+}
+#endif
+
+const MetricsSystem::Metric& DetourTransaction::GetPauseMetric()
+{
+    return s_pause;
+}
+
+void DetourTransaction::RecordPause()
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    // Threads are only stopped while a patch that does not fit in one instruction is written.
+    auto pause = DetourGetLastPause();
+#else
+    // Detours keeps the queued threads suspended from 'DetourUpdateThread' until the end of the transaction.
+    auto pause = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_suspendTime)
+                     .count();
 #endif
+
+    s_pause.Set(pause);
+    Log::trace("Threads were paused for {} us", pause);
 }
 
 void DetourTransaction::SetState(const State aState)
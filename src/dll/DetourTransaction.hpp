@@ -1,9 +1,12 @@
 #pragma once
 
-#ifdef RED4EXT_PLATFORM_MACOS
-#include <mach/mach.h>
-#endif
+#include "ProfiledMutex.hpp"
+#include "Systems/MetricsSystem.hpp"
 
+/*
+ * Only one transaction exists at a time, the hook table and the hooking system open theirs from different threads. A
+ * transaction waits for the previous one to end before it begins.
+ */
 class DetourTransaction
 {
 public:
@@ -21,6 +24,9 @@ public:
     bool Commit();
     bool Abort();
 
+    // Time the other threads were stopped by the last transaction, in microseconds.
+    static const MetricsSystem::Metric& GetPauseMetric();
+
 private:
     enum class State : uint8_t
     {
@@ -32,15 +38,15 @@ private:
     };
 
     void SetState(const State aState);
-    void QueueThreadsForUpdate();
+    void RecordPause();
 
     const std::source_location m_source;
+    std::unique_lock<ProfiledMutex> m_lock;
     State m_state;
 #ifndef RED4EXT_PLATFORM_MACOS
+    void QueueThreadsForUpdate();
+
     std::vector<wil::unique_handle> m_handles;
-#else
-    std::vector<thread_t> m_threads;
-    thread_act_array_t m_threadArray;
-    mach_msg_type_number_t m_threadCount;
+    std::chrono::steady_clock::time_point m_suspendTime;
 #endif
 };
@@ -0,0 +1,380 @@
+#include "stdafx.hpp"
+#include "HeapAccounting.hpp"
+#include "App.hpp"
+#include "Utils.hpp"
+
+#include <array>
+#include <new>
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <fishhook.h>
+#include <mach-o/dyld.h>
+#include <malloc/malloc.h>
+#endif
+
+namespace
+{
+struct Slot
+{
+    HMODULE module;
+    std::chrono::steady_clock::time_point attachTime;
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    const mach_header* header;
+    intptr_t slide;
+#endif
+
+    // Bumped when the slot is released, the deltas the threads still hold for the previous plugin are dropped.
+    std::atomic<uint32_t> generation;
+
+    MetricsSystem::Metric liveBytes;
+    MetricsSystem::Metric allocations;
+
+    // Allocations per second since the plugin was loaded, updated on every flush. The peak is the highest average seen.
+    MetricsSystem::Metric allocationRate;
+};
+
+struct PendingDelta
+{
+    int64_t bytes;
+    int64_t allocations;
+    uint32_t generation;
+};
+
+constexpr int64_t FlushBytesThreshold = 64 * 1024;
+constexpr int64_t FlushAllocationsThreshold = 256;
+
+std::mutex g_mutex;
+size_t g_slotCount = 0;
+Slot g_slots[HeapAccounting::MaxSlots];
+std::vector<size_t> g_freeSlots;
+
+// Plain TLS without a destructor, whatever is still pending (below the thresholds) when a thread exits is dropped.
+thread_local PendingDelta t_pending[HeapAccounting::MaxSlots];
+
+void Flush(size_t aIndex)
+{
+    auto& pending = t_pending[aIndex];
+    auto& slot = g_slots[aIndex];
+
+    // Left over from the plugin that had the slot before.
+    if (pending.generation != slot.generation.load(std::memory_order_relaxed))
+    {
+        pending = {0, 0, slot.generation.load(std::memory_order_relaxed)};
+        return;
+    }
+
+    // Memory allocated before the imports were rebound (static initializers, 'Query') is freed without having been
+    // counted, the live bytes stop at zero instead of going negative.
+    slot.liveBytes.Add(pending.bytes, 0);
+    slot.allocations.Add(pending.allocations);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - slot.attachTime;
+    if (elapsed.count() > 0)
+    {
+        slot.allocationRate.Set(static_cast<int64_t>(slot.allocations.GetValue() / elapsed.count()));
+    }
+
+    pending.bytes = 0;
+    pending.allocations = 0;
+}
+
+void Record(size_t aIndex, int64_t aBytes, int64_t aAllocations)
+{
+    auto& pending = t_pending[aIndex];
+
+    const auto generation = g_slots[aIndex].generation.load(std::memory_order_relaxed);
+    if (pending.generation != generation)
+    {
+        pending = {0, 0, generation};
+    }
+
+    pending.bytes += aBytes;
+    pending.allocations += aAllocations;
+
+    if (pending.bytes >= FlushBytesThreshold || pending.bytes <= -FlushBytesThreshold ||
+        pending.allocations >= FlushAllocationsThreshold)
+    {
+        Flush(aIndex);
+    }
+}
+
+Slot* GetSlot(HMODULE aModule)
+{
+    for (size_t i = 0; i < g_slotCount; i++)
+    {
+        if (g_slots[i].module == aModule)
+        {
+            return &g_slots[i];
+        }
+    }
+
+    return nullptr;
+}
+
+#ifdef RED4EXT_PLATFORM_MACOS
+int64_t GetAllocationSize(const void* aPtr)
+{
+    return aPtr ? static_cast<int64_t>(malloc_size(aPtr)) : 0;
+}
+
+template<size_t Index>
+struct Wrappers
+{
+    static void* Malloc(size_t aSize)
+    {
+        auto ptr = std::malloc(aSize);
+        Record(Index, GetAllocationSize(ptr), 1);
+        return ptr;
+    }
+
+    static void* Calloc(size_t aCount, size_t aSize)
+    {
+        auto ptr = std::calloc(aCount, aSize);
+        Record(Index, GetAllocationSize(ptr), 1);
+        return ptr;
+    }
+
+    static void* Realloc(void* aPtr, size_t aSize)
+    {
+        auto oldSize = GetAllocationSize(aPtr);
+
+        auto ptr = std::realloc(aPtr, aSize);
+        if (ptr || aSize == 0)
+        {
+            Record(Index, GetAllocationSize(ptr) - oldSize, aPtr ? 0 : 1);
+        }
+
+        return ptr;
+    }
+
+    static void Free(void* aPtr)
+    {
+        Record(Index, -GetAllocationSize(aPtr), 0);
+        std::free(aPtr);
+    }
+
+    static void* New(size_t aSize)
+    {
+        auto ptr = ::operator new(aSize);
+        Record(Index, GetAllocationSize(ptr), 1);
+        return ptr;
+    }
+
+    static void* NewNothrow(size_t aSize, const std::nothrow_t& aTag) noexcept
+    {
+        auto ptr = ::operator new(aSize, aTag);
+        Record(Index, GetAllocationSize(ptr), 1);
+        return ptr;
+    }
+
+    static void Delete(void* aPtr) noexcept
+    {
+        Record(Index, -GetAllocationSize(aPtr), 0);
+        ::operator delete(aPtr);
+    }
+
+    static void DeleteSized(void* aPtr, size_t) noexcept
+    {
+        Delete(aPtr);
+    }
+
+    static int32_t Rebind(const mach_header* aHeader, intptr_t aSlide)
+    {
+        // Array forms share the scalar wrappers, the default implementations are the same.
+        rebinding rebindings[] = {
+            {"malloc", reinterpret_cast<void*>(&Malloc), nullptr},
+            {"calloc", reinterpret_cast<void*>(&Calloc), nullptr},
+            {"realloc", reinterpret_cast<void*>(&Realloc), nullptr},
+            {"free", reinterpret_cast<void*>(&Free), nullptr},
+            {"_Znwm", reinterpret_cast<void*>(&New), nullptr},
+            {"_Znam", reinterpret_cast<void*>(&New), nullptr},
+            {"_ZnwmRKSt9nothrow_t", reinterpret_cast<void*>(&NewNothrow), nullptr},
+            {"_ZnamRKSt9nothrow_t", reinterpret_cast<void*>(&NewNothrow), nullptr},
+            {"_ZdlPv", reinterpret_cast<void*>(&Delete), nullptr},
+            {"_ZdaPv", reinterpret_cast<void*>(&Delete), nullptr},
+            {"_ZdlPvm", reinterpret_cast<void*>(&DeleteSized), nullptr},
+            {"_ZdaPvm", reinterpret_cast<void*>(&DeleteSized), nullptr},
+        };
+
+        return rebind_symbols_image(const_cast<mach_header*>(aHeader), aSlide, rebindings, std::size(rebindings));
+    }
+};
+
+// Points the imports back to the system allocator.
+int32_t Restore(const mach_header* aHeader, intptr_t aSlide)
+{
+    using New_t = void* (*)(size_t);
+    using NewNothrow_t = void* (*)(size_t, const std::nothrow_t&) noexcept;
+    using Delete_t = void (*)(void*) noexcept;
+    using DeleteSized_t = void (*)(void*, size_t) noexcept;
+
+    rebinding rebindings[] = {
+        {"malloc", reinterpret_cast<void*>(&std::malloc), nullptr},
+        {"calloc", reinterpret_cast<void*>(&std::calloc), nullptr},
+        {"realloc", reinterpret_cast<void*>(&std::realloc), nullptr},
+        {"free", reinterpret_cast<void*>(&std::free), nullptr},
+        {"_Znwm", reinterpret_cast<void*>(static_cast<New_t>(&::operator new)), nullptr},
+        {"_Znam", reinterpret_cast<void*>(static_cast<New_t>(&::operator new[])), nullptr},
+        {"_ZnwmRKSt9nothrow_t", reinterpret_cast<void*>(static_cast<NewNothrow_t>(&::operator new)), nullptr},
+        {"_ZnamRKSt9nothrow_t", reinterpret_cast<void*>(static_cast<NewNothrow_t>(&::operator new[])), nullptr},
+        {"_ZdlPv", reinterpret_cast<void*>(static_cast<Delete_t>(&::operator delete)), nullptr},
+        {"_ZdaPv", reinterpret_cast<void*>(static_cast<Delete_t>(&::operator delete[])), nullptr},
+        {"_ZdlPvm", reinterpret_cast<void*>(static_cast<DeleteSized_t>(&::operator delete)), nullptr},
+        {"_ZdaPvm", reinterpret_cast<void*>(static_cast<DeleteSized_t>(&::operator delete[])), nullptr},
+    };
+
+    return rebind_symbols_image(const_cast<mach_header*>(aHeader), aSlide, rebindings, std::size(rebindings));
+}
+
+using Rebind_t = int32_t (*)(const mach_header*, intptr_t);
+
+template<size_t... Indices>
+constexpr std::array<Rebind_t, sizeof...(Indices)> MakeRebinders(std::index_sequence<Indices...>)
+{
+    return {&Wrappers<Indices>::Rebind...};
+}
+
+constexpr auto g_rebinders = MakeRebinders(std::make_index_sequence<HeapAccounting::MaxSlots>());
+#endif
+
+// Restores the imports, unless the image is already gone, and makes the slot available to the next plugin.
+void Release(Slot& aSlot, bool aIsLoaded)
+{
+    const auto index = static_cast<size_t>(&aSlot - g_slots);
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    if (aIsLoaded && Restore(aSlot.header, aSlot.slide) != 0)
+    {
+        // The image would keep calling the wrappers of the slot, do not hand it out again.
+        Log::warn("Could not restore the allocator imports of heap accounting slot {}, it will not be reused", index);
+        aSlot.module = nullptr;
+        return;
+    }
+#else
+    RED4EXT_UNUSED_PARAMETER(aIsLoaded);
+#endif
+
+    auto metricsSystem = App::Get()->GetMetricsSystem();
+    metricsSystem->Unpublish(aSlot.liveBytes);
+    metricsSystem->Unpublish(aSlot.allocations);
+    metricsSystem->Unpublish(aSlot.allocationRate);
+
+    aSlot.module = nullptr;
+    aSlot.generation.fetch_add(1, std::memory_order_relaxed);
+    aSlot.liveBytes.Reset();
+    aSlot.allocations.Reset();
+    aSlot.allocationRate.Reset();
+
+    g_freeSlots.push_back(index);
+}
+} // namespace
+
+bool HeapAccounting::Attach(HMODULE aModule, const std::filesystem::path& aPath)
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    std::scoped_lock _(g_mutex);
+
+    // A previous image might have been unloaded without being reported, do not let its slot shadow this one.
+    if (auto previous = GetSlot(aModule))
+    {
+        Release(*previous, false);
+    }
+
+    if (g_freeSlots.empty() && g_slotCount == MaxSlots)
+    {
+        Log::warn("Heap accounting is limited to {} loaded plugins, allocations of '{}' will not be tracked",
+                  MaxSlots, aPath);
+        return false;
+    }
+
+    const mach_header* header = nullptr;
+    intptr_t slide = 0;
+
+    std::error_code ec;
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+    {
+        auto name = _dyld_get_image_name(i);
+        if (name && std::filesystem::equivalent(name, aPath, ec))
+        {
+            header = _dyld_get_image_header(i);
+            slide = _dyld_get_image_vmaddr_slide(i);
+            break;
+        }
+    }
+
+    if (!header)
+    {
+        Log::warn("Could not find the loaded image of '{}', its allocations will not be tracked", aPath);
+        return false;
+    }
+
+    auto index = g_freeSlots.empty() ? g_slotCount : g_freeSlots.back();
+    if (g_rebinders[index](header, slide) != 0)
+    {
+        Log::warn("Could not rebind the allocator imports of '{}', its allocations will not be tracked", aPath);
+        return false;
+    }
+
+    auto& slot = g_slots[index];
+    slot.module = aModule;
+    slot.attachTime = std::chrono::steady_clock::now();
+    slot.header = header;
+    slot.slide = slide;
+
+    if (index == g_slotCount)
+    {
+        g_slotCount++;
+    }
+    else
+    {
+        g_freeSlots.pop_back();
+    }
+
+    Log::trace("Allocator imports of '{}' were rebound to heap accounting slot {}", aPath, index);
+    return true;
+#else
+    RED4EXT_UNUSED_PARAMETER(aModule);
+    RED4EXT_UNUSED_PARAMETER(aPath);
+    return false;
+#endif
+}
+
+void HeapAccounting::Publish(HMODULE aModule, std::string_view aName)
+{
+    std::scoped_lock _(g_mutex);
+
+    auto slot = GetSlot(aModule);
+    if (!slot)
+    {
+        return;
+    }
+
+    auto metricsSystem = App::Get()->GetMetricsSystem();
+
+    metricsSystem->Publish(fmt::format("plugins.{}.heap.live_bytes", aName), slot->liveBytes);
+    metricsSystem->Publish(fmt::format("plugins.{}.heap.allocations", aName), slot->allocations);
+    metricsSystem->Publish(fmt::format("plugins.{}.heap.allocation_rate", aName), slot->allocationRate);
+}
+
+void HeapAccounting::Report(HMODULE aModule, std::string_view aName)
+{
+    std::scoped_lock _(g_mutex);
+
+    auto slot = GetSlot(aModule);
+    if (!slot)
+    {
+        return;
+    }
+
+    Flush(static_cast<size_t>(slot - g_slots));
+
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - slot->attachTime).count();
+    auto allocations = slot->allocations.GetValue();
+    auto rate = seconds > 0 ? allocations / seconds : 0.0;
+
+    Log::info("{} heap usage: {} live byte(s), {} peak byte(s), {} allocation(s) ({:.1f}/s)", aName,
+              slot->liveBytes.GetValue(), slot->liveBytes.GetPeak(), allocations, rate);
+
+    Release(*slot, true);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+ * Per-plugin heap accounting. The allocator imports (malloc, free, operator new / delete, ...) of a plugin's image are
+ * rebound to wrappers that attribute the allocated bytes to the plugin. Every plugin gets its own set of wrappers (a
+ * slot), the statistics are batched per thread and flushed into the plugin's metrics. 'Report' restores the imports and
+ * frees the slot for the next plugin.
+ */
+namespace HeapAccounting
+{
+constexpr size_t MaxSlots = 64;
+
+bool Attach(HMODULE aModule, const std::filesystem::path& aPath);
+void Publish(HMODULE aModule, std::string_view aName);
+void Report(HMODULE aModule, std::string_view aName);
+} // namespace HeapAccounting
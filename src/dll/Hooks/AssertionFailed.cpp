@@ -1,20 +1,8 @@
 #include "AssertionFailed.hpp"
-#include "Addresses.hpp"
 #include "App.hpp"
-#include "Detail/AddressHashes.hpp"
-#include "Hook.hpp"
 #include "stdafx.hpp"
 
-namespace
-{
-
-bool isAttached = false;
-
-void _AssertionFailed(const char*, int, const char*, const char*, ...);
-
-Hook<decltype(&_AssertionFailed)> AssertionFailed_fnc(Hashes::AssertionFailed, &_AssertionFailed);
-
-void _AssertionFailed(const char* aFile, int aLineNum, const char* aCondition, const char* aMessage, ...)
+void Hooks::AssertionFailed::Detour(const char* aFile, int aLineNum, const char* aCondition, const char* aMessage, ...)
 {
     Log::error("Crash report");
     Log::error("------------");
@@ -46,49 +34,5 @@ void _AssertionFailed(const char* aFile, int aLineNum, const char* aCondition, c
     Log::error("------------");
     spdlog::details::registry::instance().flush_all();
 
-    AssertionFailed_fnc(aFile, aLineNum, aCondition, msg);
-}
-} // namespace
-
-bool Hooks::AssertionFailed::Attach()
-{
-    Log::trace("Trying to attach the hook for the assertion failed function at {:#x}...",
-                  AssertionFailed_fnc.GetAddress());
-
-    auto result = AssertionFailed_fnc.Attach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not attach the hook for the assertion failed function. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for the assertion failed function was attached");
-    }
-
-    isAttached = result == NO_ERROR;
-    return isAttached;
-}
-
-bool Hooks::AssertionFailed::Detach()
-{
-    if (!isAttached)
-    {
-        return false;
-    }
-
-    Log::trace("Trying to detach the hook for the assertion failed function at {:#x}...",
-                  AssertionFailed_fnc.GetAddress());
-
-    auto result = AssertionFailed_fnc.Detach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not detach the hook for the assertion failed function. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for the assertion failed function was detached");
-    }
-
-    isAttached = result != NO_ERROR;
-    return !isAttached;
+    Original(aFile, aLineNum, aCondition, msg);
 }
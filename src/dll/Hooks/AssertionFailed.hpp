@@ -2,6 +2,7 @@
 
 namespace Hooks::AssertionFailed
 {
-bool Attach();
-bool Detach();
+void Detour(const char* aFile, int aLineNum, const char* aCondition, const char* aMessage, ...);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::AssertionFailed
@@ -1,22 +1,12 @@
 #include "CGameApplication.hpp"
-#include "Addresses.hpp"
-#include "Detail/AddressHashes.hpp"
-#include "Hook.hpp"
+#include "App.hpp"
 
 #include "States/BaseInitializationState.hpp"
 #include "States/InitializationState.hpp"
 #include "States/RunningState.hpp"
 #include "States/ShutdownState.hpp"
 
-namespace
-{
-bool isAttached = false;
-
-bool _CGameApplication_AddState(RED4ext::CGameApplication* aThis, RED4ext::IGameState* aState);
-Hook<decltype(&_CGameApplication_AddState)> CGameApplication_AddState(Hashes::CGameApplication_AddState,
-                                                                      &_CGameApplication_AddState);
-
-bool _CGameApplication_AddState(RED4ext::CGameApplication* aThis, RED4ext::IGameState* aState)
+bool Hooks::CGameApplication::Detour(RED4ext::CGameApplication* aThis, RED4ext::IGameState* aState)
 {
     bool success = true;
     try
@@ -73,49 +63,8 @@ bool _CGameApplication_AddState(RED4ext::CGameApplication* aThis, RED4ext::IGame
         Log::warn("An unknown exception occurred while changing the virtual functions for the game states");
     }
 
-    return CGameApplication_AddState(aThis, aState);
-}
-} // namespace
-
-bool Hooks::CGameApplication::Attach()
-{
-    Log::trace("Trying to attach the hook for the game application at {:#x}...",
-                  CGameApplication_AddState.GetAddress());
-
-    auto result = CGameApplication_AddState.Attach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not attach the hook for the game application. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for the game application was attached");
-    }
-
-    isAttached = result == NO_ERROR;
-    return isAttached;
-}
-
-bool Hooks::CGameApplication::Detach()
-{
-    if (!isAttached)
-    {
-        return false;
-    }
-
-    Log::trace("Trying to detach the hook for the game application at {:#x}...",
-                  CGameApplication_AddState.GetAddress());
-
-    auto result = CGameApplication_AddState.Detach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not detach the hook for the game application. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for the game application was detached");
-    }
+    auto result = Original(aThis, aState);
+    App::Get()->GetEventSystem()->Emit(Events::GameStateAdded{aThis, aState});
 
-    isAttached = result != NO_ERROR;
-    return !isAttached;
+    return result;
 }
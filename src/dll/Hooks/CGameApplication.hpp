@@ -2,6 +2,7 @@
 
 namespace Hooks::CGameApplication
 {
-bool Attach();
-bool Detach();
+bool Detour(RED4ext::CGameApplication* aThis, RED4ext::IGameState* aState);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::CGameApplication
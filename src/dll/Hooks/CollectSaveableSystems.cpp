@@ -1,18 +1,10 @@
 #include "CollectSaveableSystems.hpp"
-#include "Addresses.hpp"
+#include "App.hpp"
 #include "Detail/AddressHashes.hpp"
-#include "Hook.hpp"
 #include "stdafx.hpp"
 
-namespace
-{
-bool isAttached = false;
-
-void _CollectSaveableSystems(void* a1, const RED4ext::DynArray<RED4ext::Handle<RED4ext::IScriptable>>& aAllSystems);
-Hook<decltype(&_CollectSaveableSystems)> GameInstance_CollectSaveableSystems(
-    Hashes::GameInstance_CollectSaveableSystems, &_CollectSaveableSystems);
-
-void _CollectSaveableSystems(void* a1, const RED4ext::DynArray<RED4ext::Handle<RED4ext::IScriptable>>& aAllSystems)
+void Hooks::CollectSaveableSystems::Detour(void* a1,
+                                           const RED4ext::DynArray<RED4ext::Handle<RED4ext::IScriptable>>& aAllSystems)
 {
     static constexpr auto MaxSaveableSystems = 160;
     static constexpr auto PreSaveVFuncIndex = 0x130 / sizeof(uintptr_t);
@@ -35,49 +27,6 @@ void _CollectSaveableSystems(void* a1, const RED4ext::DynArray<RED4ext::Handle<R
             break;
     }
 
-    GameInstance_CollectSaveableSystems(a1, saveableSystems);
-}
-} // namespace
-
-bool Hooks::CollectSaveableSystems::Attach()
-{
-    Log::trace("Trying to attach the hook for collect saveable systems at {:#x}...",
-                  GameInstance_CollectSaveableSystems.GetAddress());
-
-    auto result = GameInstance_CollectSaveableSystems.Attach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not attach the hook for collect saveable systems. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for collect saveable systems was attached");
-    }
-
-    isAttached = result == NO_ERROR;
-    return isAttached;
-}
-
-bool Hooks::CollectSaveableSystems::Detach()
-{
-    if (!isAttached)
-    {
-        return false;
-    }
-
-    Log::trace("Trying to detach the hook for collect saveable systems at {:#x}...",
-                  GameInstance_CollectSaveableSystems.GetAddress());
-
-    auto result = GameInstance_CollectSaveableSystems.Detach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not detach the hook for collect saveable systems. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for collect saveable systems was detached");
-    }
-
-    isAttached = result != NO_ERROR;
-    return !isAttached;
+    Original(a1, saveableSystems);
+    App::Get()->GetEventSystem()->Emit(Events::SaveableSystemsCollected{&saveableSystems});
 }
@@ -2,6 +2,7 @@
 
 namespace Hooks::CollectSaveableSystems
 {
-bool Attach();
-bool Detach();
+void Detour(void* a1, const RED4ext::DynArray<RED4ext::Handle<RED4ext::IScriptable>>& aAllSystems);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::CollectSaveableSystems
@@ -1,8 +1,5 @@
 #include "ExecuteProcess.hpp"
-#include "Addresses.hpp"
 #include "App.hpp"
-#include "Detail/AddressHashes.hpp"
-#include "Hook.hpp"
 #include "ScriptCompiler/ScriptCompilerSettings.hpp"
 #include "Systems/ScriptCompilationSystem.hpp"
 #include "Platform.hpp"
@@ -13,17 +10,11 @@
 #include <dlfcn.h>
 #endif
 
-namespace
+bool Hooks::ExecuteProcess::Detour(void* a1, RED4ext::CString& aCommand, FixedWString& aArgs,
+                                    RED4ext::CString& aCurrentDirectory, char a5)
 {
-bool isAttached = false;
+    App::Get()->GetEventSystem()->Emit(Events::ProcessExecuting{aCommand.c_str()});
 
-bool _Global_ExecuteProcess(void* a1, RED4ext::CString& aCommand, FixedWString& aArgs,
-                            RED4ext::CString& aCurrentDirectory, char a5);
-Hook<decltype(&_Global_ExecuteProcess)> Global_ExecuteProcess(Hashes::Global_ExecuteProcess, &_Global_ExecuteProcess);
-
-bool _Global_ExecuteProcess(void* a1, RED4ext::CString& aCommand, FixedWString& aArgs,
-                            RED4ext::CString& aCurrentDirectory, char a5)
-{
 #ifdef RED4EXT_PLATFORM_MACOS
     // On macOS, the script compiler is likely "scc" instead of "scc.exe"
     const char* sccExeName = "scc.exe";
@@ -36,7 +27,7 @@ bool _Global_ExecuteProcess(void* a1, RED4ext::CString& aCommand, FixedWString&
     
     if (!isScc)
     {
-        return Global_ExecuteProcess(a1, aCommand, aArgs, aCurrentDirectory, a5);
+        return Original(a1, aCommand, aArgs, aCurrentDirectory, a5);
     }
 
     auto sccPath = std::filesystem::path(aCommand.c_str());
@@ -67,49 +58,7 @@ bool _Global_ExecuteProcess(void* a1, RED4ext::CString& aCommand, FixedWString&
 #else
     Log::info(L"Final redscript compilation arg string: '{}'", newArgs.str);
 #endif
-    return Global_ExecuteProcess(a1, aCommand, newArgs, aCurrentDirectory, a5);
-}
-} // namespace
-
-bool Hooks::ExecuteProcess::Attach()
-{
-    Log::trace("Trying to attach the hook for execute process at {:#x}...", Global_ExecuteProcess.GetAddress());
-
-    auto result = Global_ExecuteProcess.Attach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not attach the hook for execute process. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for execute process was attached");
-    }
-
-    isAttached = result == NO_ERROR;
-    return isAttached;
-}
-
-bool Hooks::ExecuteProcess::Detach()
-{
-    if (!isAttached)
-    {
-        return false;
-    }
-
-    Log::trace("Trying to detach the hook for execute process at {:#x}...", Global_ExecuteProcess.GetAddress());
-
-    auto result = Global_ExecuteProcess.Detach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not detach the hook for execute process. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for execute process was detached");
-    }
-
-    isAttached = result != NO_ERROR;
-    return !isAttached;
+    return Original(a1, aCommand, newArgs, aCurrentDirectory, a5);
 }
 
 bool ExecuteScc(SccApi& scc)
@@ -1,10 +1,13 @@
 #pragma once
+#include "Systems/ScriptCompilationSystem.hpp"
+
 #include <scc.h>
 
 namespace Hooks::ExecuteProcess
 {
-bool Attach();
-bool Detach();
+bool Detour(void* a1, RED4ext::CString& aCommand, FixedWString& aArgs, RED4ext::CString& aCurrentDirectory, char a5);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::ExecuteProcess
 
 bool ExecuteScc(SccApi& scc);
@@ -0,0 +1,468 @@
+#include "HookTable.hpp"
+#include "Addresses.hpp"
+#include "DetourTransaction.hpp"
+#include "Detail/AddressHashes.hpp"
+#include "ProfiledMutex.hpp"
+#include "Systems/MetricsSystem.hpp"
+
+#include "AssertionFailed.hpp"
+#include "CGameApplication.hpp"
+#include "CollectSaveableSystems.hpp"
+#include "ExecuteProcess.hpp"
+#include "InitScripts.hpp"
+#include "LoadScripts.hpp"
+#include "Main_Hooks.hpp"
+#include "ValidateScripts.hpp"
+#include "gsmState_SessionActive.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+enum class Kind : uint8_t
+{
+    Required,
+    Optional,
+    Diagnostic
+};
+
+struct Counters
+{
+    MetricsSystem::Metric calls;
+    MetricsSystem::Metric time;
+};
+
+std::atomic_bool g_isInstrumented = false;
+
+// Every detour gets its own counters.
+template<auto Detour>
+inline Counters g_counters;
+
+class ScopedSample
+{
+public:
+    ScopedSample(Counters& aCounters)
+        : m_counters(aCounters)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedSample()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+
+        m_counters.calls.Add(1);
+        m_counters.time.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+private:
+    Counters& m_counters;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Attached in place of the detour, counts the calls and the time spent in them (the original included) while the
+// instrumentation is enabled.
+template<auto Detour, typename = decltype(Detour)>
+struct Instrumented
+{
+    // C-variadic detours cannot be forwarded, they are attached as they are.
+    static constexpr bool IsSupported = false;
+    static constexpr auto Thunk = Detour;
+};
+
+template<auto Detour, typename R, typename... Args>
+struct Instrumented<Detour, R (*)(Args...)>
+{
+    static constexpr bool IsSupported = true;
+
+    static R Thunk(Args... aArgs)
+    {
+        if (!g_isInstrumented.load(std::memory_order_relaxed))
+        {
+            return Detour(std::forward<Args>(aArgs)...);
+        }
+
+        ScopedSample _(g_counters<Detour>);
+        return Detour(std::forward<Args>(aArgs)...);
+    }
+};
+
+struct Descriptor
+{
+    const char* name;
+    std::uint32_t hash;
+    Kind kind;
+
+    int32_t (*attach)(std::uintptr_t aAddress);
+    int32_t (*detach)();
+
+    Counters* counters;
+};
+
+template<auto Detour, auto* Original>
+int32_t AttachHook(std::uintptr_t aAddress)
+{
+    constexpr auto Thunk = Instrumented<Detour>::Thunk;
+    *Original = reinterpret_cast<decltype(Detour)>(aAddress);
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    return DetourAttach(reinterpret_cast<void**>(Original), reinterpret_cast<void*>(Thunk));
+#else
+    return DetourAttach(Original, Thunk);
+#endif
+}
+
+template<auto Detour, auto* Original>
+int32_t DetachHook()
+{
+    constexpr auto Thunk = Instrumented<Detour>::Thunk;
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    return DetourDetach(reinterpret_cast<void**>(Original), reinterpret_cast<void*>(Thunk));
+#else
+    return DetourDetach(Original, Thunk);
+#endif
+}
+
+template<auto Detour, auto* Original>
+constexpr Descriptor MakeHook(const char* aName, std::uint32_t aHash, Kind aKind)
+{
+    static_assert(std::is_same_v<decltype(Detour), std::remove_pointer_t<decltype(Original)>>,
+                  "The original slot must have the type of the detour");
+
+    auto counters = Instrumented<Detour>::IsSupported ? &g_counters<Detour> : nullptr;
+    return {aName, aHash, aKind, &AttachHook<Detour, Original>, &DetachHook<Detour, Original>, counters};
+}
+
+#define RED4EXT_HOOK(ns, hash, kind) MakeHook<&Hooks::ns::Detour, &Hooks::ns::Original>(#ns, hash, Kind::kind)
+
+// Order matters, hooks are attached from the top and detached from the bottom.
+constexpr std::array Table = {
+#ifndef RED4EXT_PLATFORM_MACOS
+    RED4EXT_HOOK(Main, Hashes::Main, Required),
+#endif
+    RED4EXT_HOOK(CGameApplication, Hashes::CGameApplication_AddState, Required),
+    RED4EXT_HOOK(ExecuteProcess, Hashes::Global_ExecuteProcess, Required),
+    RED4EXT_HOOK(InitScripts, Hashes::CBaseEngine_InitScripts, Required),
+    RED4EXT_HOOK(LoadScripts, Hashes::CBaseEngine_LoadScripts, Required),
+    RED4EXT_HOOK(ValidateScripts, Hashes::ScriptValidator_Validate, Required),
+    RED4EXT_HOOK(AssertionFailed, Hashes::AssertionFailed, Diagnostic),
+    RED4EXT_HOOK(CollectSaveableSystems, Hashes::GameInstance_CollectSaveableSystems, Optional),
+    // Emits 'SessionError', it stays attached for the plugins listening to it.
+    RED4EXT_HOOK(gsmState_SessionActive, Hashes::GsmState_SessionActive_ReportErrorCode, Optional),
+};
+
+#undef RED4EXT_HOOK
+
+constexpr auto TableHashes = []()
+{
+    std::array<std::uint32_t, Table.size()> hashes{};
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        hashes[i] = Table[i].hash;
+    }
+
+    return hashes;
+}();
+
+// Guards the attached state, the diagnostic hooks can be changed from the control socket while the game runs.
+ProfiledMutex g_mutex("hooks");
+std::array<bool, Table.size()> g_isAttached{};
+
+const Descriptor* FindHook(std::string_view aName)
+{
+    auto it = std::ranges::find_if(Table, [aName](const auto& aHook) { return aHook.name == aName; });
+    return it != Table.end() ? &*it : nullptr;
+}
+
+#ifdef RED4EXT_PLATFORM_MACOS
+// Tells the Frida script which of its diagnostic hooks to attach, it does not see the plugin hooks.
+void PublishDiagnostics()
+{
+    std::array<std::uint32_t, Table.size()> hashes{};
+    size_t count = 0;
+
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        if (g_isAttached[i] && Table[i].kind == Kind::Diagnostic)
+        {
+            hashes[count++] = Table[i].hash;
+        }
+    }
+
+    DetourPublishDiagnostics({hashes.data(), count});
+}
+#endif
+} // namespace
+
+bool Hooks::Attach(std::span<const std::string> aDiagnostics)
+{
+    for (const auto& name : aDiagnostics)
+    {
+        auto hook = FindHook(name);
+        if (!hook || hook->kind != Kind::Diagnostic)
+        {
+            Log::warn("'{}' is not a diagnostic hook, it will be ignored", name);
+        }
+    }
+
+    auto _ = g_mutex.Lock();
+
+    std::array<bool, Table.size()> isWanted{};
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        const auto& hook = Table[i];
+        isWanted[i] = hook.kind != Kind::Diagnostic || std::ranges::find(aDiagnostics, hook.name) != aDiagnostics.end();
+    }
+
+    const auto wanted = std::ranges::count(isWanted, true);
+    Log::trace("Attaching {} built-in hook(s)...", wanted);
+
+    std::array<std::uintptr_t, Table.size()> addresses{};
+    Addresses::Instance()->Resolve(TableHashes, addresses);
+
+    DetourTransaction transaction;
+    if (!transaction.IsValid())
+    {
+        return false;
+    }
+
+    size_t count = 0;
+    auto success = true;
+
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        const auto& hook = Table[i];
+        if (!isWanted[i])
+        {
+            Log::trace("The diagnostic '{}' hook is not enabled, it will not be attached", hook.name);
+            continue;
+        }
+
+        int32_t result = -1;
+        if (addresses[i] == 0)
+        {
+            Log::warn("The address of the '{}' hook could not be resolved", hook.name);
+        }
+        else
+        {
+            result = hook.attach(addresses[i]);
+        }
+
+        g_isAttached[i] = result == NO_ERROR;
+        if (g_isAttached[i])
+        {
+            Log::trace("The '{}' hook was queued for {:#x}", hook.name, addresses[i]);
+            count++;
+        }
+        else if (hook.kind == Kind::Required)
+        {
+            Log::error("Could not attach the required '{}' hook. Detour error code: {}", hook.name, result);
+            success = false;
+        }
+        else
+        {
+            Log::warn("Could not attach the optional '{}' hook. Detour error code: {}", hook.name, result);
+        }
+    }
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    // Code signing can prevent some of the hooks from being attached, run in a degraded mode instead of giving up.
+    if (!success)
+    {
+        Log::warn("One or more required hooks are not attached, some features will not be available");
+        success = true;
+    }
+#endif
+
+    if (!success || !transaction.Commit())
+    {
+        g_isAttached.fill(false);
+        return false;
+    }
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    PublishDiagnostics();
+#endif
+
+    Log::info("Attached {}/{} built-in hook(s)", count, wanted);
+    return true;
+}
+
+bool Hooks::SetDiagnostics(std::span<const std::string_view> aNames, bool aIsAttached)
+{
+    std::array<bool, Table.size()> isSelected{};
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        isSelected[i] = aNames.empty() && Table[i].kind == Kind::Diagnostic;
+    }
+
+    for (const auto& name : aNames)
+    {
+        auto hook = FindHook(name);
+        if (!hook || hook->kind != Kind::Diagnostic)
+        {
+            Log::warn("'{}' is not a diagnostic hook", name);
+            return false;
+        }
+
+        isSelected[hook - Table.data()] = true;
+    }
+
+    auto _ = g_mutex.Lock();
+
+    std::array<std::uintptr_t, Table.size()> addresses{};
+    if (aIsAttached)
+    {
+        Addresses::Instance()->Resolve(TableHashes, addresses);
+    }
+
+    DetourTransaction transaction;
+    if (!transaction.IsValid())
+    {
+        return false;
+    }
+
+    std::array<bool, Table.size()> isChanged{};
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        const auto& hook = Table[i];
+        if (!isSelected[i] || g_isAttached[i] == aIsAttached)
+        {
+            continue;
+        }
+
+        int32_t result = -1;
+        if (!aIsAttached)
+        {
+            result = hook.detach();
+        }
+        else if (addresses[i] == 0)
+        {
+            Log::warn("The address of the '{}' hook could not be resolved", hook.name);
+        }
+        else
+        {
+            result = hook.attach(addresses[i]);
+        }
+
+        // Nothing is applied if one of the hooks fails, the transaction is aborted when it goes out of scope.
+        if (result != NO_ERROR)
+        {
+            Log::warn("Could not {} the diagnostic '{}' hook. Detour error code: {}", aIsAttached ? "attach" : "detach",
+                      hook.name, result);
+            return false;
+        }
+
+        isChanged[i] = true;
+    }
+
+    if (!transaction.Commit())
+    {
+        return false;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        if (isChanged[i])
+        {
+            g_isAttached[i] = aIsAttached;
+            count++;
+        }
+    }
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    PublishDiagnostics();
+#endif
+
+    Log::info("{} {} diagnostic hook(s)", aIsAttached ? "Attached" : "Detached", count);
+    return true;
+}
+
+bool Hooks::Detach()
+{
+    auto _ = g_mutex.Lock();
+
+    DetourTransaction transaction;
+    if (!transaction.IsValid())
+    {
+        return false;
+    }
+
+    auto success = true;
+    for (auto i = Table.size(); i-- > 0;)
+    {
+        if (!g_isAttached[i])
+        {
+            continue;
+        }
+
+        auto result = Table[i].detach();
+        if (result != NO_ERROR)
+        {
+            Log::error("Could not detach the '{}' hook. Detour error code: {}", Table[i].name, result);
+            success = false;
+        }
+    }
+
+    if (!success || !transaction.Commit())
+    {
+        return false;
+    }
+
+    g_isAttached.fill(false);
+#ifdef RED4EXT_PLATFORM_MACOS
+    PublishDiagnostics();
+#endif
+
+    return true;
+}
+
+void Hooks::Publish(MetricsSystem& aMetrics)
+{
+    for (const auto& hook : Table)
+    {
+        if (hook.counters)
+        {
+            aMetrics.Publish(fmt::format("hooks.{}.calls", hook.name), hook.counters->calls);
+            aMetrics.Publish(fmt::format("hooks.{}.time_ns", hook.name), hook.counters->time);
+        }
+    }
+}
+
+std::vector<Hooks::Status> Hooks::GetStatus()
+{
+    auto _ = g_mutex.Lock();
+
+    std::vector<Status> statuses;
+    statuses.reserve(Table.size());
+
+    for (size_t i = 0; i < Table.size(); i++)
+    {
+        const auto& hook = Table[i];
+
+        Status status{hook.name, hook.kind == Kind::Required, hook.kind == Kind::Diagnostic, g_isAttached[i],
+                      hook.counters != nullptr, 0, 0};
+        if (hook.counters)
+        {
+            status.calls = static_cast<uint64_t>(hook.counters->calls.GetValue());
+            status.time = std::chrono::nanoseconds(hook.counters->time.GetValue());
+        }
+
+        statuses.push_back(status);
+    }
+
+    return statuses;
+}
+
+void Hooks::SetInstrumented(bool aIsInstrumented)
+{
+    g_isInstrumented.store(aIsInstrumented, std::memory_order_relaxed);
+}
+
+bool Hooks::IsInstrumented()
+{
+    return g_isInstrumented.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <span>
+
+class MetricsSystem;
+
+namespace Hooks
+{
+struct Status
+{
+    const char* name;
+    bool isRequired;
+
+    // Diagnostic hooks only log or report what the game does, they are attached on demand.
+    bool isDiagnostic;
+    bool isAttached;
+
+    // False for the detours the instrumentation cannot wrap, their counters stay at zero.
+    bool isInstrumentable;
+    uint64_t calls;
+    std::chrono::nanoseconds time;
+};
+
+// Attaches the essential built-in hooks and the diagnostic ones named in 'aDiagnostics' in a single transaction,
+// returns false if a required hook could not be attached.
+bool Attach(std::span<const std::string> aDiagnostics);
+
+// Attaches or detaches the named diagnostic hooks, or all of them when no name is given, in a single transaction. The
+// hooks already in the requested state are skipped; returns false if a name is not a diagnostic hook or the transaction
+// failed.
+bool SetDiagnostics(std::span<const std::string_view> aNames, bool aIsAttached);
+
+// Detaches the built-in hooks that are attached.
+bool Detach();
+
+// Publishes the call counters of the built-in hooks as 'hooks.<name>.calls' and 'hooks.<name>.time_ns'.
+void Publish(MetricsSystem& aMetrics);
+
+std::vector<Status> GetStatus();
+
+// The counters only move while the instrumentation is enabled, it is disabled by default.
+void SetInstrumented(bool aIsInstrumented);
+bool IsInstrumented();
+} // namespace Hooks
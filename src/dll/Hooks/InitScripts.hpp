@@ -2,6 +2,7 @@
 
 namespace Hooks::InitScripts
 {
-bool Attach();
-bool Detach();
+void* Detour(RED4ext::CBaseEngine* aThis, const RED4ext::CString& aScriptsBlobPath, int8_t a3, int16_t a4);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::InitScripts
@@ -1,21 +1,9 @@
 #include "LoadScripts.hpp"
-#include "Addresses.hpp"
 #include "App.hpp"
-#include "Detail/AddressHashes.hpp"
-#include "Hook.hpp"
 #include "Systems/ScriptCompilationSystem.hpp"
 
-namespace
-{
-bool isAttached = false;
-
-bool _CBaseEngine_LoadScripts(RED4ext::CBaseEngine* aEngine, const RED4ext::CString& aPath, uint64_t aTimestamp,
-                              uint64_t a4);
-Hook<decltype(&_CBaseEngine_LoadScripts)> CBaseEngine_LoadScripts(Hashes::CBaseEngine_LoadScripts,
-                                                                  &_CBaseEngine_LoadScripts);
-
-bool _CBaseEngine_LoadScripts(RED4ext::CBaseEngine* aEngine, const RED4ext::CString& aPath, uint64_t aTimestamp,
-                              uint64_t a4)
+bool Hooks::LoadScripts::Detour(RED4ext::CBaseEngine* aEngine, const RED4ext::CString& aPath, uint64_t aTimestamp,
+                                uint64_t a4)
 {
     auto scriptCompilationSystem = App::Get()->GetScriptCompilationSystem();
     const auto& scriptsBlobPath =
@@ -23,47 +11,8 @@ bool _CBaseEngine_LoadScripts(RED4ext::CBaseEngine* aEngine, const RED4ext::CStr
         : scriptCompilationSystem->HasScriptsBlob()     ? scriptCompilationSystem->GetScriptsBlob().string()
                                                         : aPath;
 
-    return CBaseEngine_LoadScripts(aEngine, scriptsBlobPath, aTimestamp, a4);
-}
-} // namespace
-
-bool Hooks::LoadScripts::Attach()
-{
-    Log::trace("Trying to attach the hook for load scripts at {:#x}...", CBaseEngine_LoadScripts.GetAddress());
-
-    auto result = CBaseEngine_LoadScripts.Attach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not attach the hook for load scripts. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for load scripts was attached");
-    }
-
-    isAttached = result == NO_ERROR;
-    return isAttached;
-}
-
-bool Hooks::LoadScripts::Detach()
-{
-    if (!isAttached)
-    {
-        return false;
-    }
-
-    Log::trace("Trying to detach the hook for load scripts at {:#x}...", CBaseEngine_LoadScripts.GetAddress());
-
-    auto result = CBaseEngine_LoadScripts.Detach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not detach the hook for load scripts. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for load scripts was detached");
-    }
+    auto result = Original(aEngine, scriptsBlobPath, aTimestamp, a4);
+    App::Get()->GetEventSystem()->Emit(Events::ScriptsLoaded{aEngine, scriptsBlobPath.c_str(), result});
 
-    isAttached = result != NO_ERROR;
-    return !isAttached;
+    return result;
 }
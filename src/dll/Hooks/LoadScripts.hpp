@@ -2,6 +2,7 @@
 
 namespace Hooks::LoadScripts
 {
-bool Attach();
-bool Detach();
+bool Detour(RED4ext::CBaseEngine* aEngine, const RED4ext::CString& aPath, uint64_t aTimestamp, uint64_t a4);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::LoadScripts
@@ -1,18 +1,8 @@
 #include "Main_Hooks.hpp"
-#include "Addresses.hpp"
 #include "App.hpp"
-#include "Detail/AddressHashes.hpp"
-#include "Hook.hpp"
 #include "stdafx.hpp"
 
-namespace
-{
-bool isAttached = false;
-
-int WINAPI _Main(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow);
-Hook<decltype(&_Main)> Main_fnc(Hashes::Main, &_Main);
-
-int WINAPI _Main(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow)
+int WINAPI Hooks::Main::Detour(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow)
 {
     try
     {
@@ -29,7 +19,7 @@ int WINAPI _Main(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, i
         SHOW_MESSAGE_BOX_AND_EXIT_FILE_LINE("An unknown exception occurred while RED4ext was starting up.");
     }
 
-    auto result = Main_fnc(hInstance, hPrevInstance, pCmdLine, nCmdShow);
+    auto result = Original(hInstance, hPrevInstance, pCmdLine, nCmdShow);
 
     try
     {
@@ -48,45 +38,3 @@ int WINAPI _Main(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, i
 
     return result;
 }
-} // namespace
-
-bool Hooks::Main::Attach()
-{
-    Log::trace("Trying to attach the hook for the main function at {:#x}...", Main_fnc.GetAddress());
-
-    auto result = Main_fnc.Attach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not attach the hook for the main function. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for the main function was attached");
-    }
-
-    isAttached = result == NO_ERROR;
-    return isAttached;
-}
-
-bool Hooks::Main::Detach()
-{
-    if (!isAttached)
-    {
-        return false;
-    }
-
-    Log::trace("Trying to detach the hook for the main function at {:#x}...", Main_fnc.GetAddress());
-
-    auto result = Main_fnc.Detach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not detach the hook for the main function. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for the main function was detached");
-    }
-
-    isAttached = result != NO_ERROR;
-    return !isAttached;
-}
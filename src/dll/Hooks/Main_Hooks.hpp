@@ -2,6 +2,7 @@
 
 namespace Hooks::Main
 {
-bool Attach();
-bool Detach();
+int WINAPI Detour(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::Main
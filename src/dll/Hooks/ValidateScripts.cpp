@@ -1,23 +1,12 @@
 #include "ValidateScripts.hpp"
-#include "Addresses.hpp"
 #include "App.hpp"
-#include "Detail/AddressHashes.hpp"
-#include "Hook.hpp"
 #include "RED4ext/Scripting/ScriptReport.hpp"
 #include "Systems/ScriptCompilationSystem.hpp"
 
-namespace
-{
-bool isAttached = false;
-
-bool _ScriptValidator_Validate(uint64_t self, uint64_t a1, RED4ext::ScriptReport& aReport);
-Hook<decltype(&_ScriptValidator_Validate)> ScriptValidator_Validate(Hashes::ScriptValidator_Validate,
-                                                                    &_ScriptValidator_Validate);
-
-bool _ScriptValidator_Validate(uint64_t self, uint64_t a1, RED4ext::ScriptReport& aReport)
+bool Hooks::ValidateScripts::Detour(uint64_t self, uint64_t a1, RED4ext::ScriptReport& aReport)
 {
     aReport.fillErrors = true;
-    const auto result = ScriptValidator_Validate(self, a1, aReport);
+    const auto result = Original(self, a1, aReport);
     std::vector<ValidationError> validationErrors;
 
     for (std::uint32_t i = 0; i < std::max(aReport.errors->size, 1u) - 1; ++i)
@@ -37,6 +26,9 @@ bool _ScriptValidator_Validate(uint64_t self, uint64_t a1, RED4ext::ScriptReport
         }
     }
 
+    App::Get()->GetEventSystem()->Emit(
+        Events::ScriptsValidated{static_cast<uint32_t>(validationErrors.size()), result});
+
     const auto& incompatiblePlugins = App::Get()->GetPluginSystem()->GetIncompatiblePlugins();
     const auto message = WritePopupMessage(validationErrors, incompatiblePlugins);
     if (message)
@@ -46,48 +38,6 @@ bool _ScriptValidator_Validate(uint64_t self, uint64_t a1, RED4ext::ScriptReport
 
     return result;
 }
-} // namespace
-
-bool Hooks::ValidateScripts::Attach()
-{
-    Log::trace("Trying to attach the hook for validate scripts at {:#x}...", ScriptValidator_Validate.GetAddress());
-
-    auto result = ScriptValidator_Validate.Attach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not attach the hook for validate scripts. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for validate scripts was attached");
-    }
-
-    isAttached = result == NO_ERROR;
-    return isAttached;
-}
-
-bool Hooks::ValidateScripts::Detach()
-{
-    if (!isAttached)
-    {
-        return false;
-    }
-
-    Log::trace("Trying to detach the hook for validate scripts at {:#x}...", ScriptValidator_Validate.GetAddress());
-
-    auto result = ScriptValidator_Validate.Detach();
-    if (result != NO_ERROR)
-    {
-        Log::error("Could not detach the hook for validate scripts. Detour error code: {}", result);
-    }
-    else
-    {
-        Log::trace("The hook for validate scripts was detached");
-    }
-
-    isAttached = result != NO_ERROR;
-    return !isAttached;
-}
 
 std::optional<std::wstring> WritePopupMessage(const std::vector<ValidationError>& validationErrors,
                                               const std::vector<PluginSystem::PluginName>& incompatiblePlugins)
@@ -123,7 +73,7 @@ std::optional<std::wstring> WritePopupMessage(const std::vector<ValidationError>
 
         for (const auto& plugin : incompatiblePlugins)
         {
-            fmt::format_to(outIt, L"- {}\n", plugin);
+            fmt::format_to(outIt, L"- {}\n", Utils::Widen(plugin));
         }
         fmt::format_to(outIt, L"\n");
     }
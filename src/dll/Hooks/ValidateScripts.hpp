@@ -1,11 +1,13 @@
 #pragma once
+#include "RED4ext/Scripting/ScriptReport.hpp"
 #include "ScriptValidationError.hpp"
 #include "Systems/PluginSystem.hpp"
 
 namespace Hooks::ValidateScripts
 {
-bool Attach();
-bool Detach();
+bool Detour(uint64_t self, uint64_t a1, RED4ext::ScriptReport& aReport);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::ValidateScripts
 
 std::optional<std::wstring> WritePopupMessage(const std::vector<ValidationError>& validationErrors,
@@ -1,6 +1,8 @@
 #pragma once
+
 namespace Hooks::gsmState_SessionActive
 {
-bool Attach();
-bool Detach();
+void Detour(uintptr_t aThis);
+
+inline decltype(&Detour) Original = nullptr;
 } // namespace Hooks::gsmState_SessionActive
@@ -15,40 +15,52 @@ namespace Log
 
 #ifdef RED4EXT_PLATFORM_MACOS
 
-// Convert wide string to narrow string (simplified ASCII conversion)
-inline std::string Narrow(const wchar_t* ws)
+// Convert wide string to UTF-8, 'wchar_t' holds UTF-32 on macOS.
+inline std::string Narrow(std::wstring_view ws)
 {
-    if (!ws) return "";
     std::string result;
-    result.reserve(128);
-    while (*ws)
+    result.reserve(ws.size());
+    for (wchar_t wc : ws)
     {
-        wchar_t c = *ws++;
-        if (c < 128)
+        auto c = static_cast<uint32_t>(wc);
+        if (c < 0x80)
+        {
             result += static_cast<char>(c);
+        }
+        else if (c < 0x800)
+        {
+            result += static_cast<char>(0xC0 | (c >> 6));
+            result += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000)
+        {
+            result += static_cast<char>(0xE0 | (c >> 12));
+            result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x110000)
+        {
+            result += static_cast<char>(0xF0 | (c >> 18));
+            result += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (c & 0x3F));
+        }
         else
+        {
             result += '?';
+        }
     }
     return result;
 }
 
-inline std::string Narrow(const std::wstring& ws)
+inline std::string Narrow(const wchar_t* ws)
 {
-    return Narrow(ws.c_str());
+    return ws ? Narrow(std::wstring_view(ws)) : "";
 }
 
-inline std::string Narrow(std::wstring_view ws)
+inline std::string Narrow(const std::wstring& ws)
 {
-    std::string result;
-    result.reserve(ws.size());
-    for (wchar_t c : ws)
-    {
-        if (c < 128)
-            result += static_cast<char>(c);
-        else
-            result += '?';
-    }
-    return result;
+    return Narrow(std::wstring_view(ws));
 }
 
 // Pass-through for narrow strings
@@ -87,6 +99,12 @@ struct is_wide_char<std::wstring&> : std::true_type {};
 template<>
 struct is_wide_char<const std::wstring&> : std::true_type {};
 
+// The arguments are converted before spdlog checks the level, skip them when the message is filtered out.
+inline bool ShouldLog(spdlog::level::level_enum aLevel)
+{
+    return spdlog::default_logger_raw()->should_log(aLevel);
+}
+
 // Convert a single argument: wide strings become narrow, others pass through
 template<typename T>
 auto ConvertArg(T&& arg)
@@ -115,36 +133,66 @@ auto ConvertArg(T&& arg)
 template<typename... Args>
 void trace(const wchar_t* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::trace))
+    {
+        return;
+    }
+
     spdlog::trace(fmt::runtime(Narrow(fmt)), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void debug(const wchar_t* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::debug))
+    {
+        return;
+    }
+
     spdlog::debug(fmt::runtime(Narrow(fmt)), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void info(const wchar_t* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::info))
+    {
+        return;
+    }
+
     spdlog::info(fmt::runtime(Narrow(fmt)), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void warn(const wchar_t* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::warn))
+    {
+        return;
+    }
+
     spdlog::warn(fmt::runtime(Narrow(fmt)), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void error(const wchar_t* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::err))
+    {
+        return;
+    }
+
     spdlog::error(fmt::runtime(Narrow(fmt)), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void critical(const wchar_t* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::critical))
+    {
+        return;
+    }
+
     spdlog::critical(fmt::runtime(Narrow(fmt)), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
@@ -152,36 +200,66 @@ void critical(const wchar_t* fmt, Args&&... args)
 template<typename... Args>
 void trace(const char* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::trace))
+    {
+        return;
+    }
+
     spdlog::trace(fmt::runtime(fmt), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void debug(const char* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::debug))
+    {
+        return;
+    }
+
     spdlog::debug(fmt::runtime(fmt), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void info(const char* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::info))
+    {
+        return;
+    }
+
     spdlog::info(fmt::runtime(fmt), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void warn(const char* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::warn))
+    {
+        return;
+    }
+
     spdlog::warn(fmt::runtime(fmt), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void error(const char* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::err))
+    {
+        return;
+    }
+
     spdlog::error(fmt::runtime(fmt), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
 template<typename... Args>
 void critical(const char* fmt, Args&&... args)
 {
+    if (!detail::ShouldLog(spdlog::level::critical))
+    {
+        return;
+    }
+
     spdlog::critical(fmt::runtime(fmt), detail::ConvertArg(std::forward<Args>(args))...);
 }
 
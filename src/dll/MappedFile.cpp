@@ -0,0 +1,120 @@
+#include "stdafx.hpp"
+#include "MappedFile.hpp"
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::filesystem::path& aPath, std::error_code& aError)
+{
+    std::unique_ptr<MappedFile> file(new MappedFile());
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    auto fd = open(aPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        aError = std::error_code(errno, std::generic_category());
+        return nullptr;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0)
+    {
+        aError = std::error_code(errno, std::generic_category());
+        close(fd);
+        return nullptr;
+    }
+
+    file->m_size = static_cast<size_t>(info.st_size);
+    if (file->m_size > 0)
+    {
+        auto data = mmap(nullptr, file->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            aError = std::error_code(errno, std::generic_category());
+            close(fd);
+            return nullptr;
+        }
+
+        file->m_data = data;
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(fd);
+#else
+    // Share delete access so the cache can evict files that are still mapped.
+    file->m_file = CreateFile(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file->m_file == INVALID_HANDLE_VALUE)
+    {
+        aError = std::error_code(GetLastError(), std::system_category());
+        return nullptr;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file->m_file, &size))
+    {
+        aError = std::error_code(GetLastError(), std::system_category());
+        return nullptr;
+    }
+
+    file->m_size = static_cast<size_t>(size.QuadPart);
+    if (file->m_size > 0)
+    {
+        file->m_mapping = CreateFileMapping(file->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!file->m_mapping)
+        {
+            aError = std::error_code(GetLastError(), std::system_category());
+            return nullptr;
+        }
+
+        file->m_data = MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!file->m_data)
+        {
+            aError = std::error_code(GetLastError(), std::system_category());
+            return nullptr;
+        }
+    }
+#endif
+
+    aError.clear();
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    if (m_data)
+    {
+        munmap(const_cast<void*>(m_data), m_size);
+    }
+#else
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+#endif
+}
+
+const void* MappedFile::GetData() const
+{
+    return m_data;
+}
+
+size_t MappedFile::GetSize() const
+{
+    return m_size;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+ * Read-only memory mapping of a whole file.
+ */
+class MappedFile
+{
+public:
+    static std::unique_ptr<MappedFile> Open(const std::filesystem::path& aPath, std::error_code& aError);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const void* GetData() const;
+    size_t GetSize() const;
+
+private:
+    MappedFile() = default;
+
+    const void* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifndef RED4EXT_PLATFORM_MACOS
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
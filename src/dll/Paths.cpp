@@ -35,9 +35,9 @@ std::filesystem::path Paths::GetX64Dir() const
 #ifdef RED4EXT_PLATFORM_MACOS
     // On macOS the game bundle layout doesn't include a Windows-style `<game_root>/bin/x64`.
     // Keep RED4ext assets (addresses/symbol mappings, etc.) under `<game_root>/red4ext/bin/x64`.
-    return GetRED4extDir() / L"bin" / L"x64";
+    return GetRED4extDir() / "bin" / "x64";
 #else
-    return GetRootDir() / L"bin" / L"x64";
+    return GetRootDir() / "bin" / "x64";
 #endif
 }
 
@@ -48,45 +48,50 @@ std::filesystem::path Paths::GetExe() const
 
 std::filesystem::path Paths::GetRED4extDir() const
 {
-    return GetRootDir() / L"red4ext";
+    return GetRootDir() / "red4ext";
 }
 
 std::filesystem::path Paths::GetLogsDir() const
 {
-    return GetRED4extDir() / L"logs";
+    return GetRED4extDir() / "logs";
 }
 
 std::filesystem::path Paths::GetPluginsDir() const
 {
-    return GetRED4extDir() / L"plugins";
+    return GetRED4extDir() / "plugins";
+}
+
+std::filesystem::path Paths::GetCacheDir() const
+{
+    return GetRED4extDir() / "cache";
 }
 
 std::filesystem::path Paths::GetRedscriptPathsFile() const
 {
-    return GetRED4extDir() / L"redscript_paths.txt";
+    return GetRED4extDir() / "redscript_paths.txt";
 }
 
 std::filesystem::path Paths::GetR6Scripts() const
 {
-    return GetRootDir() / L"r6" / L"scripts";
+    return GetRootDir() / "r6" / "scripts";
 }
 
 std::filesystem::path Paths::GetDefaultScriptsBlob() const
 {
-    return GetRootDir() / L"r6" / L"cache" / "final.redscripts";
+    return GetRootDir() / "r6" / "cache" / "final.redscripts";
 }
 
 std::filesystem::path Paths::GetR6CacheModded() const
 {
-    return GetRootDir() / L"r6" / L"cache" / L"modded";
+    return GetRootDir() / "r6" / "cache" / "modded";
 }
 
 std::filesystem::path Paths::GetR6Dir() const
 {
-    return GetRootDir() / L"r6";
+    return GetRootDir() / "r6";
 }
 
 const std::filesystem::path Paths::GetConfigFile() const
 {
-    return GetRED4extDir() / L"config.ini";
+    return GetRED4extDir() / "config.ini";
 }
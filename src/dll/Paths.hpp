@@ -14,6 +14,7 @@ public:
     std::filesystem::path GetRED4extDir() const;
     std::filesystem::path GetLogsDir() const;
     std::filesystem::path GetPluginsDir() const;
+    std::filesystem::path GetCacheDir() const;
     std::filesystem::path GetRedscriptPathsFile() const;
 
     std::filesystem::path GetR6Scripts() const;
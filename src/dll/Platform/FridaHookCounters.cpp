@@ -0,0 +1,33 @@
+#include "stdafx.hpp"
+#include "FridaHookCounters.hpp"
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <algorithm>
+#include <cstring>
+
+extern "C"
+{
+[[gnu::visibility("default"), gnu::used]] RED4extFridaHookCounterTable RED4extFridaHookCounters = {
+    FridaHookCounters::Version, std::size(RED4extFridaHookCounterTable{}.entries), 0, 0, {}};
+}
+
+std::vector<FridaHookCounters::Counter> FridaHookCounters::Collect()
+{
+    auto& table = RED4extFridaHookCounters;
+
+    const auto count = std::min(__atomic_load_n(&table.count, __ATOMIC_ACQUIRE), table.capacity);
+
+    std::vector<Counter> counters;
+    counters.reserve(count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const auto& entry = table.entries[i];
+
+        std::string_view name(entry.name, strnlen(entry.name, sizeof(entry.name)));
+        counters.push_back({name, __atomic_load_n(&entry.calls, __ATOMIC_RELAXED)});
+    }
+
+    return counters;
+}
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <cstdint>
+
+/*
+ * Call counters of the hooks 'red4ext_hooks.js' installs in Frida Gadget mode. The script finds the table by its
+ * exported symbol, claims an entry per hook when it installs them and stores the entry's counter with a plain memory
+ * write on every call. Frida runs the callbacks of a script under its JavaScript lock, so an entry has one writer at a
+ * time; RED4ext only reads the table.
+ *
+ * The layout is shared with the script, bump 'Version' when it changes.
+ */
+extern "C"
+{
+struct RED4extFridaHookCounter
+{
+    char name[56];
+
+    // Written by the script with a single aligned 64-bit store, never as two halves.
+    uint64_t calls;
+};
+
+struct RED4extFridaHookCounterTable
+{
+    uint32_t version;
+    uint32_t capacity;
+
+    // Entries claimed by the script, increased after the name of the entry is written.
+    uint32_t count;
+    uint32_t reserved;
+
+    RED4extFridaHookCounter entries[32];
+};
+}
+
+namespace FridaHookCounters
+{
+inline constexpr uint32_t Version = 1;
+
+struct Counter
+{
+    std::string_view name;
+    uint64_t calls;
+};
+
+// Returns the counters of the hooks the script registered, in the order it registered them.
+std::vector<Counter> Collect();
+} // namespace FridaHookCounters
+#endif
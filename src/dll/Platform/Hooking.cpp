@@ -6,7 +6,9 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #include <libkern/OSCacheControl.h>
+#include <mach/mach.h>
 #include <vector>
+#include <algorithm>
 #include <cstring>
 #include <cstdint>
 
@@ -28,27 +30,53 @@ namespace
 
 #ifdef RED4EXT_USE_FRIDA_GADGET
 // Frida Gadget mode - minimal state tracking
-bool g_inTransaction = false;
+std::atomic_bool g_inTransaction = false;
 int g_hookCount = 0;
 #else
 // Native hook mode - full trampoline management
+//
+// A hook is applied as a single atomic store of a 4-byte 'B' whenever an island (a jump to the detour) can be placed
+// within the +/-128 MiB range of the branch, so no thread has to be suspended. The architecture only guarantees that
+// concurrently executing threads see either the old or the new instruction when both are one of B/BL/NOP/BRK/SVC/ISB;
+// in practice the cores we target fetch an aligned word atomically for any instruction, which is what the fast path
+// relies on. When no island fits, a 16-byte absolute jump is written instead, with every thread suspended and checked
+// to not be inside the bytes being replaced.
+constexpr size_t JumpSize = 16;
+constexpr size_t BranchSize = 4;
+constexpr size_t MaxPatchWords = JumpSize / sizeof(uint32_t);
+
+// The longest sequence an instruction of the prologue is relocated into, see 'RelocateInstruction'.
+constexpr size_t MaxRelocatedWords = 6;
+constexpr int64_t BranchRange = 128ll * 1024 * 1024;
+constexpr uint32_t SuspendRetries = 32;
+
 struct Trampoline
 {
     void* target;
     void* detour;
-    void* original;
     void* trampolineMem;
     size_t trampolineSize;
-    
+
+    // The relocated prologue followed by a jump back to the target, this is what the hook calls as the original.
+    uint32_t* prologue;
+
+    // 4 bytes when the target branches to the island at the start of the trampoline, 16 for an absolute jump.
+    size_t patchSize;
+    uint32_t patch[MaxPatchWords];
+    uint32_t displaced[MaxPatchWords];
+
     Trampoline(void* aTarget, void* aDetour, void* aTrampolineMem, size_t aSize)
         : target(aTarget)
         , detour(aDetour)
-        , original(aTarget)
         , trampolineMem(aTrampolineMem)
         , trampolineSize(aSize)
+        , prologue(nullptr)
+        , patchSize(0)
+        , patch{}
+        , displaced{}
     {
     }
-    
+
     ~Trampoline()
     {
         if (trampolineMem != MAP_FAILED && trampolineMem != nullptr)
@@ -58,8 +86,17 @@ struct Trampoline
     }
 };
 
+struct PendingPatch
+{
+    Trampoline* trampoline;
+    void** pointer;
+    bool isAttach;
+};
+
 std::vector<std::unique_ptr<Trampoline>> g_trampolines;
+std::vector<PendingPatch> g_pending;
 bool g_inTransaction = false;
+int64_t g_lastPause = 0;
 
 // ARM64 instruction encoding helpers
 inline uint32_t EncodeLdrX16Imm(uint64_t imm)
@@ -76,12 +113,440 @@ inline uint32_t EncodeBrX16()
     return 0xD61F0200;
 }
 
+// B <label>, returns 0 when the destination is out of range.
+inline uint32_t EncodeB(const void* aFrom, const void* aTo)
+{
+    auto offset = reinterpret_cast<intptr_t>(aTo) - reinterpret_cast<intptr_t>(aFrom);
+    if (offset < -BranchRange || offset >= BranchRange)
+    {
+        return 0;
+    }
+
+    return 0x14000000 | ((static_cast<uint32_t>(offset) >> 2) & 0x03FFFFFF);
+}
+
+inline void EncodeJump(uint32_t* aCode, const void* aAddress)
+{
+    aCode[0] = EncodeLdrX16Imm(8);
+    aCode[1] = EncodeBrX16();
+    std::memcpy(&aCode[2], &aAddress, sizeof(aAddress));
+}
+
+inline bool IsAbsoluteJump(const uint32_t* aCode)
+{
+    return aCode[0] == EncodeLdrX16Imm(8) && aCode[1] == EncodeBrX16();
+}
+
+inline bool IsUnconditionalBranch(uint32_t aInstruction)
+{
+    return (aInstruction & 0xFC000000) == 0x14000000;
+}
+
+inline int64_t SignExtend(uint64_t aValue, uint32_t aBits)
+{
+    const auto shift = 64 - aBits;
+    return static_cast<int64_t>(aValue << shift) >> shift;
+}
+
+// LDR Xn, #8 followed by a branch over the address it loads.
+inline void EncodeLoadAddress(uint32_t* aCode, uint32_t aRegister, uint64_t aAddress)
+{
+    aCode[0] = 0x58000040 | aRegister;
+    aCode[1] = 0x14000003;
+    std::memcpy(&aCode[2], &aAddress, sizeof(aAddress));
+}
+
+/*
+ * Writes the instruction that was at 'aPc' into the trampoline, rewriting the ones that address relative to the PC into
+ * absolute sequences that use x16 or their own register. Returns the number of words written, 0 when the instruction
+ * can not be relocated (SIMD literal loads).
+ */
+size_t RelocateInstruction(uint32_t aInstruction, uintptr_t aPc, uint32_t* aCode)
+{
+    // B, BL
+    if ((aInstruction & 0x7C000000) == 0x14000000)
+    {
+        const auto destination = aPc + SignExtend(aInstruction & 0x03FFFFFF, 26) * 4;
+        if (IsUnconditionalBranch(aInstruction))
+        {
+            EncodeJump(aCode, reinterpret_cast<void*>(destination));
+            return 4;
+        }
+
+        // LDR x16, #12; BLR x16; B #12; address. The call returns to the branch over the address.
+        aCode[0] = 0x58000070;
+        aCode[1] = 0xD63F0200;
+        aCode[2] = 0x14000003;
+        std::memcpy(&aCode[3], &destination, sizeof(destination));
+        return 5;
+    }
+
+    // B.cond, CBZ, CBNZ, TBZ, TBNZ: the condition now skips to an absolute jump, otherwise it falls past it.
+    const auto isImm19Branch = (aInstruction & 0xFF000010) == 0x54000000 || (aInstruction & 0x7E000000) == 0x34000000;
+    const auto isImm14Branch = (aInstruction & 0x7E000000) == 0x36000000;
+    if (isImm19Branch || isImm14Branch)
+    {
+        const auto bits = isImm19Branch ? 19u : 14u;
+        const auto mask = ((1u << bits) - 1) << 5;
+        const auto destination = aPc + SignExtend((aInstruction & mask) >> 5, bits) * 4;
+
+        aCode[0] = (aInstruction & ~mask) | (2u << 5);
+        aCode[1] = 0x14000005;
+        EncodeJump(&aCode[2], reinterpret_cast<void*>(destination));
+        return 6;
+    }
+
+    // LDR (literal), LDRSW (literal), PRFM (literal)
+    if ((aInstruction & 0x3B000000) == 0x18000000)
+    {
+        if ((aInstruction & 0x04000000) != 0)
+        {
+            return 0;
+        }
+
+        const auto opc = aInstruction >> 30;
+        if (opc == 3)
+        {
+            // A prefetch is only a hint, a NOP does.
+            aCode[0] = 0xD503201F;
+            return 1;
+        }
+
+        const auto reg = aInstruction & 0x1F;
+        const auto address = aPc + SignExtend((aInstruction >> 5) & 0x7FFFF, 19) * 4;
+
+        constexpr uint32_t Loads[] = {0xB9400000, 0xF9400000, 0xB9800000};
+        EncodeLoadAddress(aCode, reg, address);
+        aCode[4] = Loads[opc] | (reg << 5) | reg;
+        return 5;
+    }
+
+    // ADR, ADRP
+    if ((aInstruction & 0x1F000000) == 0x10000000)
+    {
+        const auto imm = SignExtend((((aInstruction >> 5) & 0x7FFFF) << 2) | ((aInstruction >> 29) & 0x3), 21);
+        const auto isPage = (aInstruction & 0x80000000) != 0;
+        const auto address = isPage ? (aPc & ~uintptr_t(0xFFF)) + (imm << 12) : aPc + imm;
+
+        EncodeLoadAddress(aCode, aInstruction & 0x1F, address);
+        return 4;
+    }
+
+    aCode[0] = aInstruction;
+    return 1;
+}
+
+// Relocates the displaced prologue and jumps back after it, returns the number of words written or 0 on failure.
+size_t RelocatePrologue(const Trampoline& aTrampoline, uint32_t* aCode)
+{
+    const auto target = reinterpret_cast<uintptr_t>(aTrampoline.target);
+    const auto count = aTrampoline.patchSize / sizeof(uint32_t);
+
+    // Another hook's absolute jump, which uses x16 across its instructions: calling the original is following it.
+    if (IsAbsoluteJump(static_cast<const uint32_t*>(aTrampoline.target)))
+    {
+        void* destination;
+        std::memcpy(&destination, reinterpret_cast<const void*>(target + 2 * sizeof(uint32_t)), sizeof(destination));
+
+        EncodeJump(aCode, destination);
+        return MaxPatchWords;
+    }
+
+    size_t written = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto instruction = aTrampoline.displaced[i];
+
+        auto size = RelocateInstruction(instruction, target + i * sizeof(uint32_t), aCode + written);
+        if (size == 0)
+        {
+            spdlog::error("[Hooking] Instruction {:#x} at {}+{} can not be relocated", instruction,
+                          aTrampoline.target, i * sizeof(uint32_t));
+            return 0;
+        }
+
+        written += size;
+
+        // Nothing falls through an unconditional branch, like another hook's 'B' to its island.
+        if (IsUnconditionalBranch(instruction))
+        {
+            return written;
+        }
+    }
+
+    EncodeJump(aCode + written, reinterpret_cast<void*>(target + aTrampoline.patchSize));
+    return written + MaxPatchWords;
+}
+
 // Calculate page-aligned size
 inline size_t AlignToPage(size_t size)
 {
     size_t pageSize = sysconf(_SC_PAGESIZE);
     return (size + pageSize - 1) & ~(pageSize - 1);
 }
+
+// Tries to map the trampoline within branch range of the target, falls back to anywhere in the address space.
+void* AllocateTrampoline(void* aTarget, size_t aSize)
+{
+    constexpr uintptr_t Step = 1024 * 1024;
+
+    const auto target = reinterpret_cast<uintptr_t>(aTarget) & ~(Step - 1);
+    for (uintptr_t distance = Step; distance < static_cast<uintptr_t>(BranchRange) - Step; distance += Step)
+    {
+        for (auto hint : {target + distance, target - distance})
+        {
+            auto mem = mmap(reinterpret_cast<void*>(hint), aSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1, 0);
+            if (mem == MAP_FAILED)
+            {
+                continue;
+            }
+
+            if (EncodeB(aTarget, mem) != 0)
+            {
+                return mem;
+            }
+
+            munmap(mem, aSize);
+        }
+    }
+
+    return mmap(nullptr, aSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+}
+
+// Only stores the code, the page must already be writable. Neither allocates nor logs, it runs while the other threads
+// are suspended.
+void StoreCode(void* aTarget, const uint32_t* aCode, size_t aSize)
+{
+    if (aSize == BranchSize)
+    {
+        __atomic_store_n(static_cast<uint32_t*>(aTarget), aCode[0], __ATOMIC_RELEASE);
+    }
+    else
+    {
+        std::memcpy(aTarget, aCode, aSize);
+    }
+
+    sys_icache_invalidate(aTarget, aSize);
+}
+
+bool WriteCode(void* aTarget, const uint32_t* aCode, size_t aSize)
+{
+    uint32_t oldProt;
+    if (!Platform::ProtectMemory(aTarget, aSize, Platform::Memory_ExecuteReadWrite, &oldProt))
+    {
+        spdlog::error("[Hooking] ProtectMemory failed at {}, errno={}", aTarget, errno);
+        return false;
+    }
+
+    StoreCode(aTarget, aCode, aSize);
+    Platform::ProtectMemory(aTarget, aSize, oldProt, nullptr);
+
+    return true;
+}
+
+// The code the patch writes, or the code it replaced when it is rolled back.
+const uint32_t* GetCode(const PendingPatch& aPatch, bool aIsRollback = false)
+{
+    return aPatch.isAttach != aIsRollback ? aPatch.trampoline->patch : aPatch.trampoline->displaced;
+}
+
+// Writes back what the patches replaced, returns false if one of them stays applied.
+bool RollBack(const std::vector<const PendingPatch*>& aPatches)
+{
+    auto isRolledBack = true;
+    for (auto patch : aPatches)
+    {
+        auto trampoline = patch->trampoline;
+        isRolledBack &= WriteCode(trampoline->target, GetCode(*patch, true), trampoline->patchSize);
+    }
+
+    if (!isRolledBack)
+    {
+        spdlog::error("[Hooking] Some patches could not be rolled back and stay applied");
+    }
+
+    return isRolledBack;
+}
+
+// Restores the protections 'ProtectPatches' changed, in reverse so pages shared by several patches end up as they were.
+void RestoreProtections(const std::vector<const PendingPatch*>& aPatches, const std::vector<uint32_t>& aProtections)
+{
+    for (auto i = aProtections.size(); i > 0; i--)
+    {
+        auto trampoline = aPatches[i - 1]->trampoline;
+        Platform::ProtectMemory(trampoline->target, trampoline->patchSize, aProtections[i - 1], nullptr);
+    }
+}
+
+bool ProtectPatches(const std::vector<const PendingPatch*>& aPatches, std::vector<uint32_t>& aProtections)
+{
+    aProtections.reserve(aPatches.size());
+    for (auto patch : aPatches)
+    {
+        auto trampoline = patch->trampoline;
+
+        uint32_t oldProt;
+        if (!Platform::ProtectMemory(trampoline->target, trampoline->patchSize, Platform::Memory_ExecuteReadWrite,
+                                     &oldProt))
+        {
+            spdlog::error("[Hooking] ProtectMemory failed at {}, errno={}", trampoline->target, errno);
+            RestoreProtections(aPatches, aProtections);
+
+            return false;
+        }
+
+        aProtections.push_back(oldProt);
+    }
+
+    return true;
+}
+
+bool IsInsidePatch(uintptr_t aPc, const std::vector<const PendingPatch*>& aPatches)
+{
+    for (auto patch : aPatches)
+    {
+        // A thread sitting on the first instruction executes the new code from its start, which is fine.
+        auto start = reinterpret_cast<uintptr_t>(patch->trampoline->target);
+        if (aPc > start && aPc < start + patch->trampoline->patchSize)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ResumeThreads(std::vector<thread_act_t>& aThreads)
+{
+    for (auto thread : aThreads)
+    {
+        thread_resume(thread);
+        mach_port_deallocate(mach_task_self(), thread);
+    }
+
+    aThreads.clear();
+}
+
+// Suspends the threads of the task, retrying while one of them is inside a range that is about to be rewritten.
+bool SuspendThreadsOutside(const std::vector<const PendingPatch*>& aPatches, std::vector<thread_act_t>& aSuspended)
+{
+    for (uint32_t attempt = 0; attempt < SuspendRetries; attempt++)
+    {
+        thread_act_array_t threads;
+        mach_msg_type_number_t count;
+        if (task_threads(mach_task_self(), &threads, &count) != KERN_SUCCESS)
+        {
+            return false;
+        }
+
+        auto self = mach_thread_self();
+        auto isClear = true;
+
+        // Nothing may allocate once a thread is suspended, it could hold the lock of the malloc zone.
+        aSuspended.reserve(count);
+
+        for (mach_msg_type_number_t i = 0; i < count; i++)
+        {
+            if (threads[i] == self || thread_suspend(threads[i]) != KERN_SUCCESS)
+            {
+                mach_port_deallocate(mach_task_self(), threads[i]);
+                continue;
+            }
+
+            aSuspended.push_back(threads[i]);
+
+            arm_thread_state64_t state;
+            mach_msg_type_number_t stateCount = ARM_THREAD_STATE64_COUNT;
+            if (thread_get_state(threads[i], ARM_THREAD_STATE64, reinterpret_cast<thread_state_t>(&state),
+                                 &stateCount) != KERN_SUCCESS ||
+                IsInsidePatch(arm_thread_state64_get_pc(state), aPatches))
+            {
+                isClear = false;
+            }
+        }
+
+        mach_port_deallocate(mach_task_self(), self);
+        vm_deallocate(mach_task_self(), reinterpret_cast<vm_address_t>(threads), count * sizeof(thread_act_t));
+
+        if (isClear)
+        {
+            return true;
+        }
+
+        ResumeThreads(aSuspended);
+        std::this_thread::yield();
+    }
+
+    return false;
+}
+
+// Writes the queued patches. When one can not be written, the ones already written are rolled back so the transaction
+// is either applied as a whole or not at all.
+int32_t ApplyPending()
+{
+    g_lastPause = 0;
+
+    std::vector<const PendingPatch*> written;
+    std::vector<const PendingPatch*> wide;
+    written.reserve(g_pending.size());
+
+    for (const auto& patch : g_pending)
+    {
+        auto trampoline = patch.trampoline;
+        if (trampoline->patchSize != BranchSize)
+        {
+            wide.push_back(&patch);
+            continue;
+        }
+
+        if (!WriteCode(trampoline->target, GetCode(patch), BranchSize))
+        {
+            RollBack(written);
+            return -1;
+        }
+
+        written.push_back(&patch);
+    }
+
+    if (wide.empty())
+    {
+        return NO_ERROR;
+    }
+
+    // Everything that can fail, log or allocate happens before the threads are suspended or after they are resumed.
+    std::vector<uint32_t> protections;
+    if (!ProtectPatches(wide, protections))
+    {
+        RollBack(written);
+        return -1;
+    }
+
+    std::vector<thread_act_t> suspended;
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!SuspendThreadsOutside(wide, suspended))
+    {
+        RestoreProtections(wide, protections);
+        spdlog::error("[Hooking] Could not find a point where no thread executes the patched code");
+
+        RollBack(written);
+        return -1;
+    }
+
+    for (auto patch : wide)
+    {
+        StoreCode(patch->trampoline->target, GetCode(*patch), patch->trampoline->patchSize);
+    }
+
+    ResumeThreads(suspended);
+
+    const auto pause = std::chrono::steady_clock::now() - start;
+    g_lastPause = std::chrono::duration_cast<std::chrono::microseconds>(pause).count();
+
+    RestoreProtections(wide, protections);
+    return NO_ERROR;
+}
 #endif // RED4EXT_USE_FRIDA_GADGET
 }
 
@@ -89,14 +554,16 @@ extern "C" {
 
 #ifdef RED4EXT_USE_FRIDA_GADGET
 
+[[gnu::visibility("default"), gnu::used]] RED4extFridaDiagnosticHookList RED4extFridaDiagnosticHooks = {
+    1, 0, 0, std::size(RED4extFridaDiagnosticHookList{}.hashes), {}};
+
 // ============================================================================
 // Frida Gadget Mode - Hooks handled by FridaGadget.dylib + red4ext_hooks.js
 // ============================================================================
 
 int32_t DetourTransactionBegin()
 {
-    if (g_inTransaction) return -1;
-    g_inTransaction = true;
+    if (g_inTransaction.exchange(true)) return -1;
     spdlog::debug("[Hooking] Transaction begin (Frida Gadget mode)");
     return NO_ERROR;
 }
@@ -104,17 +571,18 @@ int32_t DetourTransactionBegin()
 int32_t DetourTransactionCommit()
 {
     if (!g_inTransaction) return -1;
-    g_inTransaction = false;
     spdlog::info("[Hooking] Transaction commit: {} hooks registered (handled by Frida Gadget)", g_hookCount);
+
+    g_inTransaction = false;
     return NO_ERROR;
 }
 
 int32_t DetourTransactionAbort()
 {
     if (!g_inTransaction) return -1;
-    g_inTransaction = false;
     g_hookCount = 0;
     spdlog::debug("[Hooking] Transaction aborted");
+    g_inTransaction = false;
     return NO_ERROR;
 }
 
@@ -182,32 +650,62 @@ int32_t DetourTransactionBegin()
     return NO_ERROR;
 }
 
+// Points the original pointers back to what they were before the transaction.
+static void RestorePointers(bool aIsReleasingTrampolines)
+{
+    for (const auto& patch : g_pending)
+    {
+        auto trampoline = patch.trampoline;
+        if (patch.isAttach)
+        {
+            *patch.pointer = trampoline->target;
+            if (aIsReleasingTrampolines)
+            {
+                std::erase_if(g_trampolines, [trampoline](const std::unique_ptr<Trampoline>& t) {
+                    return t.get() == trampoline;
+                });
+            }
+        }
+        else
+        {
+            *patch.pointer = trampoline->prologue;
+        }
+    }
+}
+
 int32_t DetourTransactionCommit()
 {
     if (!g_inTransaction) return -1;
-    
-    // Thread suspension is handled by DetourTransaction class
-    // All hooks are applied atomically here
-    
+
+    // Patches are only written here, single word patches without stopping any thread.
+    auto result = ApplyPending();
+    if (result != NO_ERROR)
+    {
+        // The patches were rolled back, but a thread might have entered a trampoline in the meantime: keep them.
+        RestorePointers(false);
+    }
+
+    // Detached trampolines are kept alive, a thread might still be running through them.
+    g_pending.clear();
     g_inTransaction = false;
-    return NO_ERROR;
+
+    return result;
 }
 
 int32_t DetourTransactionAbort()
 {
     if (!g_inTransaction) return -1;
-    
-    // Clean up any pending trampolines
-    g_trampolines.clear();
-    
+
+    RestorePointers(true);
+
+    g_pending.clear();
     g_inTransaction = false;
     return NO_ERROR;
 }
 
 int32_t DetourUpdateThread(void* hThread)
 {
-    // Thread updates are handled by DetourTransaction::QueueThreadsForUpdate
-    // This is a no-op on macOS as we suspend threads directly
+    // Threads are only inspected when a patch can not be written atomically, see 'ApplyPending'.
     return NO_ERROR;
 }
 
@@ -228,84 +726,77 @@ int32_t DetourAttach(void** ppPointer, void* pDetour)
     }
     
     spdlog::debug("[Hooking] DetourAttach: target={}, detour={}", pTarget, pDetour);
+
+    // The second hook would displace the code the first one has not patched yet, hook it in the next transaction.
+    if (std::ranges::any_of(g_pending, [pTarget](const PendingPatch& aPatch)
+                            { return aPatch.trampoline->target == pTarget; }))
+    {
+        spdlog::error("[Hooking] DetourAttach failed: {} is already patched by this transaction", pTarget);
+        return -1;
+    }
     
-    // Allocate memory for trampoline - start with RW, then change to RX after writing
-    // We need at least 16 bytes: 2 instructions (8 bytes) + address (8 bytes)
-    size_t trampolineSize = AlignToPage(16);
+    // Island + relocated instructions + jump back.
+    size_t trampolineSize = AlignToPage(2 * JumpSize + MaxPatchWords * MaxRelocatedWords * sizeof(uint32_t));
     
     // First allocate as RW (not executable yet)
-    void* pTrampolineMem = mmap(NULL, trampolineSize, PROT_READ | PROT_WRITE, 
-                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    void* pTrampolineMem = AllocateTrampoline(pTarget, trampolineSize);
     if (pTrampolineMem == MAP_FAILED)
     {
         spdlog::error("[Hooking] DetourAttach failed: mmap RW failed, errno={}", errno);
         return -1;
     }
-    
-    spdlog::debug("[Hooking] Allocated trampoline memory at {} (RW)", pTrampolineMem);
-    
-    // ARM64 Jump Sequence for trampoline:
-    // LDR x16, #8  (load address from literal pool)
-    // BR x16       (branch to loaded address)
-    // .quad target (literal pool: original function address)
-    
-    uint32_t* code = reinterpret_cast<uint32_t*>(pTrampolineMem);
-    code[0] = EncodeLdrX16Imm(8);  // LDR x16, #8
-    code[1] = EncodeBrX16();       // BR x16
-    *reinterpret_cast<void**>(&code[2]) = pTarget; // Original function address
-    
-    // Now change to RX (executable)
-    if (mprotect(pTrampolineMem, trampolineSize, PROT_READ | PROT_EXEC) != 0)
+
+    auto trampoline = std::make_unique<Trampoline>(pTarget, pDetour, pTrampolineMem, trampolineSize);
+    auto code = reinterpret_cast<uint32_t*>(pTrampolineMem);
+
+    auto branch = EncodeB(pTarget, pTrampolineMem);
+    if (branch != 0)
     {
-        spdlog::error("[Hooking] DetourAttach failed: mprotect to RX failed, errno={}", errno);
-        munmap(pTrampolineMem, trampolineSize);
+        // Target: B island, island: absolute jump to the detour.
+        EncodeJump(code, pDetour);
+        code += MaxPatchWords;
+
+        trampoline->patch[0] = branch;
+        trampoline->patchSize = BranchSize;
+    }
+    else
+    {
+        // Another hook's 'B' may be there, its trampoline jumps back right after it, into the bytes a jump replaces.
+        if (IsUnconditionalBranch(*static_cast<const uint32_t*>(pTarget)))
+        {
+            spdlog::error("[Hooking] DetourAttach failed: {} starts with a branch and no island is in range", pTarget);
+            return -1;
+        }
+
+        EncodeJump(trampoline->patch, pDetour);
+        trampoline->patchSize = JumpSize;
+    }
+
+    std::memcpy(trampoline->displaced, pTarget, trampoline->patchSize);
+
+    trampoline->prologue = code;
+    if (RelocatePrologue(*trampoline, code) == 0)
+    {
+        spdlog::error("[Hooking] DetourAttach failed: the prologue of {} can not be relocated", pTarget);
         return -1;
     }
     
-    spdlog::debug("[Hooking] Changed trampoline to RX");
-    
-    // Flush instruction cache for trampoline
-    sys_icache_invalidate(pTrampolineMem, 16);
-    
-    // Patch target function to jump to detour
-    // ARM64 Jump Sequence:
-    // LDR x16, #8  (load detour address from literal pool)
-    // BR x16       (branch to detour)
-    // .quad detour (literal pool: detour function address)
-    
-    uint32_t patch[4];
-    patch[0] = EncodeLdrX16Imm(8);  // LDR x16, #8
-    patch[1] = EncodeBrX16();       // BR x16
-    *reinterpret_cast<void**>(&patch[2]) = pDetour; // Detour function address
-    
-    // Change memory protection to allow writing
-    uint32_t oldProt;
-    spdlog::debug("[Hooking] Attempting to change protection for {} (16 bytes)", pTarget);
-    if (!Platform::ProtectMemory(pTarget, 16, Platform::Memory_ExecuteReadWrite, &oldProt))
+    // Now change to RX (executable)
+    if (mprotect(pTrampolineMem, trampolineSize, PROT_READ | PROT_EXEC) != 0)
     {
-        spdlog::error("[Hooking] DetourAttach failed: ProtectMemory failed at {}, errno={}", 
-                      pTarget, errno);
-        munmap(pTrampolineMem, trampolineSize);
+        spdlog::error("[Hooking] DetourAttach failed: mprotect to RX failed, errno={}", errno);
         return -1;
     }
-    spdlog::debug("[Hooking] Protection changed, old={:#x}", oldProt);
-    
-    // Write patch
-    std::memcpy(pTarget, patch, 16);
-    spdlog::debug("[Hooking] Patch written to {}", pTarget);
-    
-    // Restore original protection
-    Platform::ProtectMemory(pTarget, 16, oldProt, nullptr);
-    
-    // Invalidate instruction cache for patched function
-    sys_icache_invalidate(pTarget, 16);
-    
-    // Store trampoline info
-    g_trampolines.emplace_back(std::make_unique<Trampoline>(pTarget, pDetour, pTrampolineMem, trampolineSize));
-    
-    // Update pointer to point to trampoline (original function)
-    *ppPointer = pTrampolineMem;
     
+    sys_icache_invalidate(pTrampolineMem, trampolineSize);
+
+    spdlog::debug("[Hooking] Trampoline at {}, {} byte patch queued for {}", pTrampolineMem, trampoline->patchSize,
+                  pTarget);
+
+    g_pending.push_back({trampoline.get(), ppPointer, true});
+    *ppPointer = trampoline->prologue;
+
+    g_trampolines.emplace_back(std::move(trampoline));
     return NO_ERROR;
 }
 
@@ -325,50 +816,55 @@ int32_t DetourDetach(void** ppPointer, void* pDetour)
     // Find the trampoline
     auto it = std::find_if(g_trampolines.begin(), g_trampolines.end(),
         [pTrampoline, pDetour](const std::unique_ptr<Trampoline>& t) {
-            return t->trampolineMem == pTrampoline && t->detour == pDetour;
+            return t->prologue == pTrampoline && t->detour == pDetour;
         });
     
     if (it == g_trampolines.end())
     {
         return -1; // Trampoline not found
     }
-    
-    auto& trampoline = *it;
-    void* pTarget = trampoline->target;
-    
-    // Restore original function
-    // We need to restore the original instructions
-    // For now, we'll assume we saved them (simplified implementation)
-    // In a full implementation, we'd need to save the original bytes
-    
-    // Change memory protection
-    uint32_t oldProt;
-    if (!Platform::ProtectMemory(pTarget, 16, Platform::Memory_ExecuteReadWrite, &oldProt))
-    {
-        return -1;
-    }
-    
-    // Restore original bytes (simplified - in reality we'd need to save them)
-    // For now, we'll just restore a simple jump back
-    // This is a limitation - a full implementation would need instruction analysis
-    
-    // Restore original protection
-    Platform::ProtectMemory(pTarget, 16, oldProt, nullptr);
-    
-    // Invalidate instruction cache
-    sys_icache_invalidate(pTarget, 16);
-    
-    // Update pointer back to original
-    *ppPointer = pTarget;
-    
-    // Remove trampoline (will be freed by unique_ptr)
-    g_trampolines.erase(it);
+
+    // The displaced instructions are written back on commit.
+    g_pending.push_back({it->get(), ppPointer, false});
+    *ppPointer = (*it)->target;
     
     return NO_ERROR;
 }
 
 #endif // RED4EXT_USE_FRIDA_GADGET
 
+int64_t DetourGetLastPause()
+{
+#ifdef RED4EXT_USE_FRIDA_GADGET
+    return 0;
+#else
+    return g_lastPause;
+#endif
+}
+
+}
+
+void DetourPublishDiagnostics([[maybe_unused]] std::span<const uint32_t> aHashes)
+{
+#ifdef RED4EXT_USE_FRIDA_GADGET
+    auto& list = RED4extFridaDiagnosticHooks;
+
+    const auto count = std::min<size_t>(aHashes.size(), list.capacity);
+    if (count < aHashes.size())
+    {
+        spdlog::warn("[Hooking] {} diagnostic hook(s) do not fit in the list published to Frida",
+                     aHashes.size() - count);
+    }
+
+    const auto generation = list.generation;
+    __atomic_store_n(&list.generation, generation + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    std::copy_n(aHashes.begin(), count, list.hashes);
+    list.count = static_cast<uint32_t>(count);
+
+    __atomic_store_n(&list.generation, generation + 2, __ATOMIC_RELEASE);
+#endif
 }
 
 #endif
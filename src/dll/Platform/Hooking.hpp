@@ -2,6 +2,7 @@
 
 #ifdef RED4EXT_PLATFORM_MACOS
 #include <cstdint>
+#include <span>
 
 #ifndef NO_ERROR
 #define NO_ERROR 0L
@@ -9,10 +10,34 @@
 
 extern "C" {
 int32_t DetourTransactionBegin();
+
+// Applies every queued patch or, when one fails, rolls back the others and restores the original pointers.
 int32_t DetourTransactionCommit();
 int32_t DetourTransactionAbort();
 int32_t DetourUpdateThread(void* hThread);
 int32_t DetourAttach(void** ppPointer, void* pDetour);
 int32_t DetourDetach(void** ppPointer, void* pDetour);
+
+// Microseconds the threads were suspended during the last commit, zero when every patch was a single atomic write.
+int64_t DetourGetLastPause();
+
+/*
+ * In Frida Gadget mode, the hashes of the diagnostic built-in hooks that are attached, published as
+ * 'RED4extFridaDiagnosticHooks'. 'red4ext_hooks.js' polls it and attaches its diagnostic hooks only while their hash is
+ * listed. The layout is shared with the script.
+ */
+struct RED4extFridaDiagnosticHookList
+{
+    uint32_t version;
+
+    // Odd while 'count' and 'hashes' are written, a reader retries when it is odd or changed while reading.
+    uint32_t generation;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t hashes[16];
+};
 }
+
+// Publishes the hashes of the attached diagnostic hooks to Frida Gadget, does nothing in native hook mode.
+void DetourPublishDiagnostics(std::span<const uint32_t> aHashes);
 #endif
@@ -28,7 +28,7 @@ bool PluginBase::Query()
     const auto stem = path.stem();
     const auto module = GetModule();
 
-    Log::trace(L"Calling 'Query' function exported by '{}'...", stem);
+    Log::trace("Calling 'Query' function exported by '{}'...", stem);
 
     using Query_t = void (*)(void*);
 #ifdef RED4EXT_PLATFORM_MACOS
@@ -36,8 +36,8 @@ bool PluginBase::Query()
     if (!queryFn)
     {
         const char* err = dlerror();
-        Log::warn(L"Could not retrieve 'Query' function from '{}'. Error: '{}', path: '{}'", stem,
-                     err ? Utils::Widen(err) : L"Unknown error", path);
+        Log::warn("Could not retrieve 'Query' function from '{}'. Error: '{}', path: '{}'", stem,
+                     err ? err : "Unknown error", path);
         return false;
     }
 #else
@@ -45,8 +45,8 @@ bool PluginBase::Query()
     if (!queryFn)
     {
         auto msg = Utils::FormatLastError();
-        Log::warn(L"Could not retrieve 'Query' function from '{}'. Error code: {}, msg: '{}', path: '{}'", stem,
-                     GetLastError(), msg, path);
+        Log::warn("Could not retrieve 'Query' function from '{}'. Error code: {}, msg: '{}', path: '{}'", stem,
+                     GetLastError(), Utils::Narrow(msg), path);
         return false;
     }
 #endif
@@ -54,16 +54,17 @@ bool PluginBase::Query()
     try
     {
         queryFn(GetPluginInfo());
+        CacheInfo();
     }
     catch (const std::exception& e)
     {
-        Log::warn(L"An exception occured while calling 'Query' function exported by '{}'. Path: '{}'", stem, path);
+        Log::warn("An exception occured while calling 'Query' function exported by '{}'. Path: '{}'", stem, path);
         Log::warn(e.what());
         return false;
     }
     catch (...)
     {
-        Log::warn(L"An unknown exception occured while calling 'Query' function exported by '{}'. Path: '{}'", stem,
+        Log::warn("An unknown exception occured while calling 'Query' function exported by '{}'. Path: '{}'", stem,
                      path);
         return false;
     }
@@ -71,18 +72,18 @@ bool PluginBase::Query()
     auto name = GetName();
     if (name.empty())
     {
-        Log::warn(L"'{}' does not have a name; one is required. Path: '{}'", stem, path);
+        Log::warn("'{}' does not have a name; one is required. Path: '{}'", stem, path);
         return false;
     }
 
     auto author = GetAuthor();
     if (author.empty())
     {
-        Log::warn(L"'{}' does not have any author(s); an author is required. Path: '{}'", stem, path);
+        Log::warn("'{}' does not have any author(s); an author is required. Path: '{}'", stem, path);
         return false;
     }
 
-    Log::trace(L"'Query' function called successfully");
+    Log::trace("'Query' function called successfully");
     return true;
 }
 
@@ -90,9 +91,9 @@ bool PluginBase::Main(RED4ext::EMainReason aReason)
 {
     const auto module = GetModule();
     const auto name = GetName();
-    const auto reasonStr = aReason == RED4ext::EMainReason::Load ? L"Load" : L"Unload";
+    const auto reasonStr = aReason == RED4ext::EMainReason::Load ? "Load" : "Unload";
 
-    Log::trace(L"Calling 'Main' function exported by '{}' with reason '{}'...", name, reasonStr);
+    Log::trace("Calling 'Main' function exported by '{}' with reason '{}'...", name, reasonStr);
 
     using Main_t = bool (*)(RED4ext::PluginHandle, RED4ext::EMainReason, const void*);
 #ifdef RED4EXT_PLATFORM_MACOS
@@ -107,29 +108,29 @@ bool PluginBase::Main(RED4ext::EMainReason aReason)
             auto success = mainFn(module, aReason, GetSdkStruct());
             if (!success)
             {
-                Log::trace(L"'Main' function returned 'false'");
+                Log::trace("'Main' function returned 'false'");
                 return false;
             }
 
-            Log::trace(L"'Main' function called successfully");
+            Log::trace("'Main' function called successfully");
         }
         catch (const std::exception& e)
         {
-            Log::warn(L"An exception occured while calling 'Main' function with reason '{}', exported by '{}'",
+            Log::warn("An exception occured while calling 'Main' function with reason '{}', exported by '{}'",
                          reasonStr, name);
             Log::warn(e.what());
             return false;
         }
         catch (...)
         {
-            Log::warn(L"An unknown exception occured while calling 'Main' function with reason '{}', exported by '{}'",
+            Log::warn("An unknown exception occured while calling 'Main' function with reason '{}', exported by '{}'",
                          reasonStr, name);
             return false;
         }
     }
     else
     {
-        Log::trace(L"'{}' does not export a 'Main' function, skipping the call", name);
+        Log::trace("'{}' does not export a 'Main' function, skipping the call", name);
     }
 
     return true;
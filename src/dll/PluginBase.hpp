@@ -10,8 +10,9 @@ public:
     virtual void* GetPluginInfo() = 0;
     virtual const void* GetSdkStruct() const = 0;
 
-    virtual const std::wstring_view GetName() const = 0;
-    virtual const std::wstring_view GetAuthor() const = 0;
+    // UTF-8, valid after a successful 'Query'.
+    virtual const std::string_view GetName() const = 0;
+    virtual const std::string_view GetAuthor() const = 0;
     virtual const RED4ext::SemVer& GetVersion() const = 0;
     virtual const RED4ext::FileVer& GetRuntimeVersion() const = 0;
     virtual const RED4ext::SemVer& GetSdkVersion() const = 0;
@@ -22,6 +23,10 @@ public:
     bool Query();
     bool Main(RED4ext::EMainReason aReason);
 
+protected:
+    // Called after 'Query', converts the strings the plugin wrote in its info once.
+    virtual void CacheInfo() = 0;
+
 private:
     std::filesystem::path m_path;
     wil::unique_hmodule m_module;
@@ -0,0 +1,408 @@
+#include "stdafx.hpp"
+#include "PoolAllocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <new>
+
+struct PoolBlock
+{
+    PoolBlock* next;
+};
+
+struct PoolSlab
+{
+    // 'SlabMagic' mixed with the slab's address, cleared when the slab is destroyed.
+    uintptr_t magic;
+
+    PoolArena* arena;
+    PoolThreadCache* owner;
+    size_t size;
+
+    uint32_t sizeClass;
+    uint32_t blockSize;
+    uint32_t capacity;
+    uint32_t carved;
+
+    PoolBlock* freeList;
+    std::atomic<PoolBlock*> remoteFree;
+
+    PoolSlab* prev;
+    PoolSlab* next;
+};
+
+namespace
+{
+constexpr std::array<uint32_t, 28> SizeClasses = {16,  32,  48,  64,   80,   96,   112,  128,  160,  192,
+                                                  224, 256, 320, 384,  448,  512,  640,  768,  896,  1024,
+                                                  1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096};
+static_assert(SizeClasses.back() == PoolArena::MaxBlockSize);
+
+constexpr uint32_t LargeSizeClass = std::numeric_limits<uint32_t>::max();
+
+// Keeps the first block 64-byte aligned, every block size is a multiple of 16 so all blocks are 16-byte aligned.
+constexpr size_t SlabHeaderSize = 128;
+static_assert(sizeof(PoolSlab) <= SlabHeaderSize);
+
+constexpr size_t LargeGranularity = 4096;
+
+constexpr uintptr_t SlabMagic = 0x52344558534C4142; // "R4EXSLAB"
+
+struct CacheEntry
+{
+    uint64_t arenaId;
+    PoolThreadCache* cache;
+};
+
+constexpr size_t CacheEntryCount = 8;
+
+std::atomic<uint64_t> g_nextArenaId = 1;
+
+// Arena ids are never reused, an entry of a destroyed arena can not match anymore.
+thread_local CacheEntry t_caches[CacheEntryCount];
+thread_local size_t t_nextCacheEntry;
+
+// Maps every size, in 16 byte steps, to the smallest size class that fits it.
+constexpr auto SizeClassLookup = []()
+{
+    std::array<uint8_t, PoolArena::MaxBlockSize / 16 + 1> lookup{};
+
+    size_t sizeClass = 0;
+    for (size_t i = 0; i < lookup.size(); i++)
+    {
+        while (SizeClasses[sizeClass] < i * 16)
+        {
+            sizeClass++;
+        }
+
+        lookup[i] = static_cast<uint8_t>(sizeClass);
+    }
+
+    return lookup;
+}();
+
+uint32_t GetSizeClass(size_t aSize)
+{
+    return SizeClassLookup[(aSize + 15) / 16];
+}
+
+PoolSlab* GetSlab(void* aPtr)
+{
+    return reinterpret_cast<PoolSlab*>(reinterpret_cast<uintptr_t>(aPtr) & ~(PoolArena::SlabSize - 1));
+}
+
+uintptr_t GetSlabMagic(const PoolSlab* aSlab)
+{
+    return SlabMagic ^ reinterpret_cast<uintptr_t>(aSlab);
+}
+
+// Checks that the pointer is the start of a block carved from a live slab.
+bool IsBlock(const PoolSlab* aSlab, void* aPtr)
+{
+    if (aSlab->magic != GetSlabMagic(aSlab))
+    {
+        return false;
+    }
+
+    auto offset = static_cast<size_t>(static_cast<char*>(aPtr) - reinterpret_cast<const char*>(aSlab));
+    if (offset < SlabHeaderSize)
+    {
+        return false;
+    }
+
+    offset -= SlabHeaderSize;
+    if (aSlab->sizeClass == LargeSizeClass)
+    {
+        return offset == 0;
+    }
+
+    return offset % aSlab->blockSize == 0 && offset / aSlab->blockSize < aSlab->carved;
+}
+
+void* PopBlock(PoolSlab* aSlab)
+{
+    if (!aSlab->freeList)
+    {
+        if (aSlab->carved < aSlab->capacity)
+        {
+            auto ptr = reinterpret_cast<char*>(aSlab) + SlabHeaderSize + aSlab->carved * aSlab->blockSize;
+            aSlab->carved++;
+
+            return ptr;
+        }
+
+        aSlab->freeList = aSlab->remoteFree.exchange(nullptr, std::memory_order_acquire);
+        if (!aSlab->freeList)
+        {
+            return nullptr;
+        }
+    }
+
+    auto block = aSlab->freeList;
+    aSlab->freeList = block->next;
+
+    return block;
+}
+} // namespace
+
+struct PoolThreadCache
+{
+    std::thread::id threadId;
+    PoolSlab* slabs[SizeClasses.size()]{};
+};
+
+PoolArena::PoolArena()
+    : m_id(g_nextArenaId.fetch_add(1, std::memory_order_relaxed))
+    , m_large(nullptr)
+    , m_reserved(0)
+{
+}
+
+PoolArena::~PoolArena()
+{
+    for (const auto& cache : m_caches)
+    {
+        for (auto slab : cache->slabs)
+        {
+            while (slab)
+            {
+                auto next = slab->next;
+                DestroySlab(slab);
+
+                slab = next;
+            }
+        }
+    }
+
+    while (m_large)
+    {
+        auto next = m_large->next;
+        DestroySlab(m_large);
+
+        m_large = next;
+    }
+}
+
+void* PoolArena::Allocate(size_t aSize)
+{
+    if (aSize > MaxBlockSize)
+    {
+        return AllocateLarge(aSize);
+    }
+
+    return AllocateSmall(GetThreadCache(), GetSizeClass(aSize));
+}
+
+bool PoolArena::Free(void* aPtr)
+{
+    if (!aPtr)
+    {
+        return true;
+    }
+
+    auto slab = GetSlab(aPtr);
+    if (!IsBlock(slab, aPtr))
+    {
+        return false;
+    }
+
+    if (slab->sizeClass == LargeSizeClass)
+    {
+        slab->arena->FreeLarge(slab);
+        return true;
+    }
+
+    auto block = static_cast<PoolBlock*>(aPtr);
+    if (slab->owner->threadId == std::this_thread::get_id())
+    {
+        block->next = slab->freeList;
+        slab->freeList = block;
+        return true;
+    }
+
+    auto head = slab->remoteFree.load(std::memory_order_relaxed);
+    do
+    {
+        block->next = head;
+    } while (!slab->remoteFree.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+
+    return true;
+}
+
+size_t PoolArena::GetReservedBytes() const
+{
+    return m_reserved.load(std::memory_order_relaxed);
+}
+
+PoolThreadCache* PoolArena::GetThreadCache()
+{
+    for (const auto& entry : t_caches)
+    {
+        if (entry.arenaId == m_id)
+        {
+            return entry.cache;
+        }
+    }
+
+    std::scoped_lock _(m_mutex);
+
+    // The entry might have been evicted, or the id belongs to a thread that has exited. Either way the cache can be
+    // (re)used by this thread.
+    const auto threadId = std::this_thread::get_id();
+    auto it = std::find_if(m_caches.begin(), m_caches.end(),
+                           [threadId](const auto& aCache) { return aCache->threadId == threadId; });
+
+    PoolThreadCache* cache;
+    if (it != m_caches.end())
+    {
+        cache = it->get();
+    }
+    else
+    {
+        auto& created = m_caches.emplace_back(std::make_unique<PoolThreadCache>());
+        created->threadId = threadId;
+
+        cache = created.get();
+    }
+
+    t_caches[t_nextCacheEntry++ % CacheEntryCount] = {m_id, cache};
+    return cache;
+}
+
+void* PoolArena::AllocateSmall(PoolThreadCache* aCache, uint32_t aSizeClass)
+{
+    auto& head = aCache->slabs[aSizeClass];
+    if (head)
+    {
+        if (auto ptr = PopBlock(head))
+        {
+            return ptr;
+        }
+
+        // The current slab is exhausted, look for one that got blocks back and move it to the front.
+        for (auto slab = head->next; slab; slab = slab->next)
+        {
+            auto ptr = PopBlock(slab);
+            if (!ptr)
+            {
+                continue;
+            }
+
+            slab->prev->next = slab->next;
+            if (slab->next)
+            {
+                slab->next->prev = slab->prev;
+            }
+
+            slab->prev = nullptr;
+            slab->next = head;
+            head->prev = slab;
+            head = slab;
+
+            return ptr;
+        }
+    }
+
+    auto slab = CreateSlab(SlabSize);
+    if (!slab)
+    {
+        return nullptr;
+    }
+
+    slab->owner = aCache;
+    slab->sizeClass = aSizeClass;
+    slab->blockSize = SizeClasses[aSizeClass];
+    slab->capacity = static_cast<uint32_t>((SlabSize - SlabHeaderSize) / slab->blockSize);
+
+    slab->next = head;
+    if (head)
+    {
+        head->prev = slab;
+    }
+
+    head = slab;
+    return PopBlock(slab);
+}
+
+void* PoolArena::AllocateLarge(size_t aSize)
+{
+    if (aSize > std::numeric_limits<size_t>::max() - SlabHeaderSize - LargeGranularity)
+    {
+        return nullptr;
+    }
+
+    auto size = (SlabHeaderSize + aSize + LargeGranularity - 1) & ~(LargeGranularity - 1);
+
+    auto slab = CreateSlab(size);
+    if (!slab)
+    {
+        return nullptr;
+    }
+
+    slab->sizeClass = LargeSizeClass;
+
+    {
+        std::scoped_lock _(m_mutex);
+
+        slab->next = m_large;
+        if (m_large)
+        {
+            m_large->prev = slab;
+        }
+
+        m_large = slab;
+    }
+
+    return reinterpret_cast<char*>(slab) + SlabHeaderSize;
+}
+
+void PoolArena::FreeLarge(PoolSlab* aSlab)
+{
+    {
+        std::scoped_lock _(m_mutex);
+
+        if (aSlab->prev)
+        {
+            aSlab->prev->next = aSlab->next;
+        }
+        else
+        {
+            m_large = aSlab->next;
+        }
+
+        if (aSlab->next)
+        {
+            aSlab->next->prev = aSlab->prev;
+        }
+    }
+
+    DestroySlab(aSlab);
+}
+
+PoolSlab* PoolArena::CreateSlab(size_t aSize)
+{
+    // Aligning every slab to its nominal size lets 'Free' find the header of any block by masking the pointer.
+    auto memory = ::operator new(aSize, std::align_val_t{SlabSize}, std::nothrow);
+    if (!memory)
+    {
+        return nullptr;
+    }
+
+    auto slab = new (memory) PoolSlab{};
+    slab->magic = GetSlabMagic(slab);
+    slab->arena = this;
+    slab->size = aSize;
+
+    m_reserved.fetch_add(aSize, std::memory_order_relaxed);
+    return slab;
+}
+
+void PoolArena::DestroySlab(PoolSlab* aSlab)
+{
+    m_reserved.fetch_sub(aSlab->size, std::memory_order_relaxed);
+
+    aSlab->magic = 0;
+    aSlab->~PoolSlab();
+    ::operator delete(aSlab, std::align_val_t{SlabSize});
+}
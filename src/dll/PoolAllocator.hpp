@@ -0,0 +1,49 @@
+#pragma once
+
+struct PoolSlab;
+struct PoolThreadCache;
+
+/*
+ * Size-class pool allocator. Small blocks are carved from slabs owned by a single thread cache, so the owning thread
+ * allocates and frees without synchronization. Blocks freed by other threads are pushed onto the slab's remote-free
+ * queue and collected by the owner once it runs out of blocks. Slabs are kept until the arena is destroyed, which
+ * releases everything that was allocated from it at once.
+ */
+class PoolArena
+{
+public:
+    static constexpr size_t SlabSize = 64 * 1024;
+    static constexpr size_t MaxBlockSize = 4096;
+
+    PoolArena();
+    ~PoolArena();
+
+    PoolArena(const PoolArena&) = delete;
+    PoolArena& operator=(const PoolArena&) = delete;
+
+    void* Allocate(size_t aSize);
+
+    // Returns false, without touching anything but the slab header, when the pointer was not allocated by an arena.
+    // The header is found by masking the pointer, so its 64 KiB aligned page must still be readable.
+    static bool Free(void* aPtr);
+
+    size_t GetReservedBytes() const;
+
+private:
+    PoolThreadCache* GetThreadCache();
+
+    void* AllocateSmall(PoolThreadCache* aCache, uint32_t aSizeClass);
+    void* AllocateLarge(size_t aSize);
+    void FreeLarge(PoolSlab* aSlab);
+
+    PoolSlab* CreateSlab(size_t aSize);
+    void DestroySlab(PoolSlab* aSlab);
+
+    const uint64_t m_id;
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<PoolThreadCache>> m_caches;
+    PoolSlab* m_large;
+
+    std::atomic<size_t> m_reserved;
+};
@@ -0,0 +1,219 @@
+#include "stdafx.hpp"
+#include "ProfiledMutex.hpp"
+#include "Platform.hpp"
+
+#include <algorithm>
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+#define RED4EXT_NOINLINE __attribute__((noinline))
+#define RED4EXT_RETURN_ADDRESS() __builtin_return_address(0)
+#else
+#include <intrin.h>
+
+#define RED4EXT_NOINLINE __declspec(noinline)
+#define RED4EXT_RETURN_ADDRESS() _ReturnAddress()
+#endif
+
+namespace
+{
+std::mutex g_registryMutex;
+ProfiledMutex* g_first = nullptr;
+
+// Only the thread holding the lock writes the statistics, a read-modify-write is not needed.
+template<typename T>
+void Increase(std::atomic<T>& aValue, T aDelta)
+{
+    aValue.store(aValue.load(std::memory_order_relaxed) + aDelta, std::memory_order_relaxed);
+}
+
+std::string DescribeSite(void* aAddress)
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    Dl_info info{};
+    if (dladdr(aAddress, &info) && info.dli_sname)
+    {
+        auto status = 0;
+        auto demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+
+        std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::free(demangled);
+
+        const auto offset = reinterpret_cast<uintptr_t>(aAddress) - reinterpret_cast<uintptr_t>(info.dli_saddr);
+        return fmt::format("{}+{:#x}", name, offset);
+    }
+#else
+    HMODULE module = nullptr;
+    if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           reinterpret_cast<LPCWSTR>(aAddress), &module))
+    {
+        const auto offset = reinterpret_cast<uintptr_t>(aAddress) - reinterpret_cast<uintptr_t>(module);
+        return fmt::format("{}+{:#x}", Platform::GetModuleFileName(module).filename().string(), offset);
+    }
+#endif
+
+    return fmt::format("{}", aAddress);
+}
+} // namespace
+
+ProfiledMutex::ProfiledMutex(const char* aName)
+    : m_name(aName)
+    , m_previous(nullptr)
+{
+    std::scoped_lock _(g_registryMutex);
+
+    m_next = g_first;
+    if (m_next)
+    {
+        m_next->m_previous = this;
+    }
+
+    g_first = this;
+}
+
+ProfiledMutex::~ProfiledMutex()
+{
+    std::scoped_lock _(g_registryMutex);
+
+    if (m_previous)
+    {
+        m_previous->m_next = m_next;
+    }
+    else
+    {
+        g_first = m_next;
+    }
+
+    if (m_next)
+    {
+        m_next->m_previous = m_previous;
+    }
+}
+
+ProfiledMutex::Stats ProfiledMutex::GetStats() const
+{
+    using std::chrono::nanoseconds;
+
+    Stats stats;
+    stats.name = m_name;
+    stats.acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+    stats.contentions = m_contentions.load(std::memory_order_relaxed);
+    stats.wait = nanoseconds(m_wait.load(std::memory_order_relaxed));
+    stats.maxWait = nanoseconds(m_maxWait.load(std::memory_order_relaxed));
+
+    const auto samples = m_holdSamples.load(std::memory_order_relaxed);
+    stats.hold = nanoseconds(samples ? m_hold.load(std::memory_order_relaxed) / static_cast<int64_t>(samples) : 0);
+
+    for (const auto& site : m_sites)
+    {
+        std::string location;
+        if (auto file = site.file.load(std::memory_order_relaxed))
+        {
+            location = fmt::format("{} ({}:{})", site.function.load(std::memory_order_relaxed),
+                                   std::filesystem::path(file).filename().string(),
+                                   site.line.load(std::memory_order_relaxed));
+        }
+        else if (auto address = site.address.load(std::memory_order_relaxed))
+        {
+            location = DescribeSite(address);
+        }
+        else
+        {
+            continue;
+        }
+
+        stats.sites.push_back({std::move(location), site.contentions.load(std::memory_order_relaxed),
+                               nanoseconds(site.wait.load(std::memory_order_relaxed))});
+    }
+
+    std::ranges::sort(stats.sites, std::ranges::greater{}, &Site::wait);
+    return stats;
+}
+
+std::vector<ProfiledMutex::Stats> ProfiledMutex::Collect()
+{
+    std::scoped_lock _(g_registryMutex);
+
+    std::vector<Stats> stats;
+    for (auto mutex = g_first; mutex; mutex = mutex->m_next)
+    {
+        stats.push_back(mutex->GetStats());
+    }
+
+    std::ranges::sort(stats, std::ranges::less{}, &Stats::name);
+    return stats;
+}
+
+RED4EXT_NOINLINE void ProfiledMutex::LockContended()
+{
+    // Called from 'lock', the return address is in the function that takes the lock only when 'lock' is inlined.
+    Wait({RED4EXT_RETURN_ADDRESS(), nullptr, nullptr, 0});
+}
+
+void ProfiledMutex::LockContended(const std::source_location& aSite)
+{
+    Wait({nullptr, aSite.function_name(), aSite.file_name(), aSite.line()});
+}
+
+void ProfiledMutex::Wait(const SiteId& aSite)
+{
+    const auto start = std::chrono::steady_clock::now();
+    m_mutex.lock();
+
+    const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    const auto waitCount = static_cast<int64_t>(wait.count());
+
+    Increase<uint64_t>(m_contentions, 1);
+    Increase(m_wait, waitCount);
+
+    if (waitCount > m_maxWait.load(std::memory_order_relaxed))
+    {
+        m_maxWait.store(waitCount, std::memory_order_relaxed);
+    }
+
+    // Keep the sites that waited the longest, a new site replaces the one that waited the least.
+    SiteCounters* slot = nullptr;
+    auto isMatched = false;
+    for (auto& site : m_sites)
+    {
+        const SiteId id{site.address.load(std::memory_order_relaxed), site.function.load(std::memory_order_relaxed),
+                        site.file.load(std::memory_order_relaxed), site.line.load(std::memory_order_relaxed)};
+        if (id == aSite)
+        {
+            slot = &site;
+            isMatched = true;
+            break;
+        }
+
+        // Empty slots have not waited at all.
+        if (!slot || site.wait.load(std::memory_order_relaxed) < slot->wait.load(std::memory_order_relaxed))
+        {
+            slot = &site;
+        }
+    }
+
+    if (!isMatched)
+    {
+        // Readers may see the fields of the previous site for a moment, they only describe it.
+        slot->address.store(aSite.address, std::memory_order_relaxed);
+        slot->function.store(aSite.function, std::memory_order_relaxed);
+        slot->file.store(aSite.file, std::memory_order_relaxed);
+        slot->line.store(aSite.line, std::memory_order_relaxed);
+        slot->contentions.store(0, std::memory_order_relaxed);
+        slot->wait.store(0, std::memory_order_relaxed);
+    }
+
+    Increase<uint64_t>(slot->contentions, 1);
+    Increase(slot->wait, waitCount);
+}
+
+void ProfiledMutex::RecordHold()
+{
+    const auto hold = std::chrono::steady_clock::now() - m_holdStart;
+    m_holdStart = {};
+
+    Increase(m_hold, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(hold).count()));
+    Increase<uint64_t>(m_holdSamples, 1);
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+
+/*
+ * 'std::mutex' that records how it is used: acquisitions, contended acquisitions, the time spent waiting, the time the
+ * lock is held and the call sites that waited the longest.
+ *
+ * An uncontended acquisition costs a 'try_lock' and a counter update, the clock is only read when the lock is
+ * contended and for one acquisition out of 'HoldSampleRate' to estimate the hold time. The statistics are only written
+ * by the thread holding the lock, so they need no synchronization of their own; readers may see them slightly out of
+ * date. Use 'std::condition_variable_any' to wait on it.
+ *
+ * Take it with 'Lock' where possible, 'lock' finds the call site from its return address, which only points at the
+ * caller when 'lock' is inlined.
+ */
+class ProfiledMutex
+{
+public:
+    static constexpr size_t MaxSites = 8;
+    static constexpr uint64_t HoldSampleRate = 64;
+
+    struct Site
+    {
+        std::string location;
+        uint64_t contentions;
+        std::chrono::nanoseconds wait;
+    };
+
+    struct Stats
+    {
+        std::string name;
+        uint64_t acquisitions;
+        uint64_t contentions;
+        std::chrono::nanoseconds wait;
+        std::chrono::nanoseconds maxWait;
+
+        // Average of the sampled acquisitions.
+        std::chrono::nanoseconds hold;
+
+        // The call sites that waited the longest, first.
+        std::vector<Site> sites;
+    };
+
+    explicit ProfiledMutex(const char* aName);
+    ~ProfiledMutex();
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock()
+    {
+        if (!m_mutex.try_lock())
+        {
+            LockContended();
+        }
+
+        OnAcquired();
+    }
+
+    [[nodiscard]] std::unique_lock<ProfiledMutex> Lock(
+        const std::source_location aSite = std::source_location::current())
+    {
+        if (!m_mutex.try_lock())
+        {
+            LockContended(aSite);
+        }
+
+        OnAcquired();
+        return {*this, std::adopt_lock};
+    }
+
+    bool try_lock()
+    {
+        if (!m_mutex.try_lock())
+        {
+            return false;
+        }
+
+        OnAcquired();
+        return true;
+    }
+
+    void unlock()
+    {
+        if (m_holdStart != std::chrono::steady_clock::time_point())
+        {
+            RecordHold();
+        }
+
+        m_mutex.unlock();
+    }
+
+    Stats GetStats() const;
+
+    // Returns the statistics of every profiled mutex that exists.
+    static std::vector<Stats> Collect();
+
+private:
+    // A site is either the return address of 'lock' or the source location given to 'Lock'.
+    struct SiteId
+    {
+        void* address;
+        const char* function;
+        const char* file;
+        uint32_t line;
+
+        bool operator==(const SiteId&) const = default;
+    };
+
+    struct SiteCounters
+    {
+        std::atomic<void*> address{nullptr};
+        std::atomic<const char*> function{nullptr};
+        std::atomic<const char*> file{nullptr};
+        std::atomic<uint32_t> line{0};
+        std::atomic<uint64_t> contentions{0};
+        std::atomic<int64_t> wait{0};
+    };
+
+    void OnAcquired()
+    {
+        auto count = m_acquisitions.load(std::memory_order_relaxed) + 1;
+        m_acquisitions.store(count, std::memory_order_relaxed);
+
+        if (count % HoldSampleRate == 0)
+        {
+            m_holdStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    void LockContended();
+    void LockContended(const std::source_location& aSite);
+    void Wait(const SiteId& aSite);
+    void RecordHold();
+
+    std::mutex m_mutex;
+    const char* m_name;
+
+    std::atomic<uint64_t> m_acquisitions{0};
+    std::atomic<uint64_t> m_contentions{0};
+    std::atomic<int64_t> m_wait{0};
+    std::atomic<int64_t> m_maxWait{0};
+    std::atomic<int64_t> m_hold{0};
+    std::atomic<uint64_t> m_holdSamples{0};
+    std::chrono::steady_clock::time_point m_holdStart{};
+
+    std::array<SiteCounters, MaxSites> m_sites{};
+
+    // Every profiled mutex is linked into a list, so they can be collected.
+    ProfiledMutex* m_previous;
+    ProfiledMutex* m_next;
+};
@@ -0,0 +1,115 @@
+#include "stdafx.hpp"
+#include "AllocatorSystem.hpp"
+#include "App.hpp"
+
+namespace
+{
+struct ArenaEntry
+{
+    HMODULE module;
+    uint64_t epoch;
+    PoolArena* arena;
+};
+
+constexpr size_t ArenaEntryCount = 4;
+
+thread_local ArenaEntry t_arenas[ArenaEntryCount];
+thread_local size_t t_nextArenaEntry;
+} // namespace
+
+ESystemType AllocatorSystem::GetType()
+{
+    return ESystemType::Allocator;
+}
+
+void AllocatorSystem::Startup()
+{
+}
+
+void AllocatorSystem::Shutdown()
+{
+    auto _ = m_mutex.Lock();
+
+    Log::trace("Releasing {} dangling pool arena(s)...", m_arenas.size());
+
+    m_arenas.clear();
+    m_epoch.fetch_add(1, std::memory_order_release);
+}
+
+void* AllocatorSystem::Allocate(HMODULE aModule, size_t aSize)
+{
+    auto arena = GetArena(aModule);
+    if (!arena)
+    {
+        return nullptr;
+    }
+
+    return arena->Allocate(aSize);
+}
+
+void AllocatorSystem::ReleaseArena(HMODULE aModule, std::string_view aName)
+{
+    auto _ = m_mutex.Lock();
+
+    auto it = m_arenas.find(aModule);
+    if (it == m_arenas.end())
+    {
+        return;
+    }
+
+    Log::debug("Releasing the pool arena of {}, {} byte(s) reserved", aName, it->second->GetReservedBytes());
+
+    m_arenas.erase(it);
+    m_epoch.fetch_add(1, std::memory_order_release);
+}
+
+PoolArena* AllocatorSystem::GetArena(HMODULE aModule)
+{
+    const auto epoch = m_epoch.load(std::memory_order_acquire);
+    for (const auto& entry : t_arenas)
+    {
+        if (entry.module == aModule && entry.epoch == epoch)
+        {
+            return entry.arena;
+        }
+    }
+
+    auto _ = m_mutex.Lock();
+
+    auto it = m_arenas.find(aModule);
+    if (it == m_arenas.end())
+    {
+        auto pluginSystem = App::Get()->GetPluginSystem();
+        if (!pluginSystem->GetPlugin(aModule))
+        {
+            Log::warn("Could not find a plugin with handle {}, the allocation request was ignored", fmt::ptr(aModule));
+            return nullptr;
+        }
+
+        it = m_arenas.emplace(aModule, std::make_unique<PoolArena>()).first;
+    }
+
+    auto arena = it->second.get();
+    t_arenas[t_nextArenaEntry++ % ArenaEntryCount] = {aModule, epoch, arena};
+
+    return arena;
+}
+
+RED4EXT_C_EXPORT void* RED4EXT_CALL RED4ext_Allocate(RED4ext::PluginHandle aHandle, std::size_t aSize)
+{
+    auto app = App::Get();
+    if (!app)
+    {
+        return nullptr;
+    }
+
+    return app->GetAllocatorSystem()->Allocate(aHandle, aSize);
+}
+
+RED4EXT_C_EXPORT void RED4EXT_CALL RED4ext_Free(void* aPtr)
+{
+    if (!PoolArena::Free(aPtr))
+    {
+        Log::warn("{} was not allocated by 'RED4ext_Allocate', the free request was ignored", fmt::ptr(aPtr));
+    }
+}
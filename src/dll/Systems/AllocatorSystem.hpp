@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ISystem.hpp"
+#include "PoolAllocator.hpp"
+#include "ProfiledMutex.hpp"
+
+class AllocatorSystem : public ISystem
+{
+public:
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+    void* Allocate(HMODULE aModule, size_t aSize);
+
+    // Releases everything the plugin allocated from its arena, pointers into it become invalid. Must only be called once
+    // the plugin's module is closed: the threads use their cached arena without the lock, so nothing may allocate from
+    // it anymore.
+    void ReleaseArena(HMODULE aModule, std::string_view aName);
+
+private:
+    PoolArena* GetArena(HMODULE aModule);
+
+    ProfiledMutex m_mutex{"allocator"};
+    std::unordered_map<HMODULE, std::unique_ptr<PoolArena>> m_arenas;
+
+    // Bumped when an arena is released, invalidates the arenas cached by the threads.
+    std::atomic<uint64_t> m_epoch{0};
+};
@@ -0,0 +1,284 @@
+#include "stdafx.hpp"
+#include "CacheSystem.hpp"
+#include "App.hpp"
+#include "Image.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+
+CacheSystem::CacheSystem(const Config::CacheConfig& aConfig, const Paths& aPaths)
+    : m_paths(aPaths)
+    , m_budget(static_cast<uintmax_t>(aConfig.maxSize) * 1024 * 1024)
+    , m_size(0)
+    , m_nextTemporary(0)
+{
+}
+
+ESystemType CacheSystem::GetType()
+{
+    return ESystemType::Cache;
+}
+
+void CacheSystem::Startup()
+{
+    if (m_budget == 0)
+    {
+        Log::debug("The cache is disabled");
+        return;
+    }
+
+    const auto dir = m_paths.GetCacheDir() / fmt::format(L"{}", Image::Get()->GetFileVersion());
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error)
+    {
+        Log::warn("Could not create the cache directory '{}', error: {}", dir, error.message());
+        return;
+    }
+
+    // Temporary files are left behind only if the game exited while an entry was being written.
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(m_paths.GetCacheDir(), error))
+    {
+        if (entry.is_regular_file(error) && entry.path().extension() == L".tmp")
+        {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    auto _ = m_mutex.Lock();
+    m_dir = dir;
+
+    Evict();
+    Log::debug("The cache holds {} byte(s) out of {} byte(s)", m_size, m_budget);
+}
+
+void CacheSystem::Shutdown()
+{
+}
+
+std::unique_ptr<MappedFile> CacheSystem::Open(const PluginBase& aPlugin, std::span<const uint8_t> aDigest)
+{
+    if (!IsEnabled() || aDigest.empty() || aDigest.size() > MaxDigestSize)
+    {
+        return nullptr;
+    }
+
+    const auto path = GetEntryPath(aPlugin, aDigest);
+
+    std::error_code error;
+    auto file = MappedFile::Open(path, error);
+    if (!file)
+    {
+        if (error != std::errc::no_such_file_or_directory)
+        {
+            Log::warn("Could not map the cache entry '{}', error: {}", path, error.message());
+        }
+
+        return nullptr;
+    }
+
+    // The modification time doubles as the last use for eviction.
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    return file;
+}
+
+bool CacheSystem::Store(const PluginBase& aPlugin, std::span<const uint8_t> aDigest, std::span<const uint8_t> aData)
+{
+    if (!IsEnabled() || aDigest.empty() || aDigest.size() > MaxDigestSize)
+    {
+        return false;
+    }
+
+    const auto path = GetEntryPath(aPlugin, aDigest);
+
+    auto temporary = path;
+    {
+        auto _ = m_mutex.Lock();
+        temporary += fmt::format(L".{}.tmp", m_nextTemporary++);
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error)
+    {
+        Log::warn("Could not create the cache directory '{}', error: {}", path.parent_path(), error.message());
+        return false;
+    }
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(aData.data()), static_cast<std::streamsize>(aData.size()));
+
+        if (!file)
+        {
+            Log::warn("Could not write the cache entry '{}'", temporary);
+
+            file.close();
+            std::filesystem::remove(temporary, error);
+
+            return false;
+        }
+    }
+
+    // Readers see either the previous entry or the complete new one, never a partially written file.
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        Log::warn("Could not move the cache entry '{}' into place, error: {}", path, error.message());
+        std::filesystem::remove(temporary, error);
+
+        return false;
+    }
+
+    auto _ = m_mutex.Lock();
+
+    m_size += aData.size();
+    if (m_size > m_budget)
+    {
+        Evict();
+    }
+
+    return true;
+}
+
+bool CacheSystem::IsEnabled() const
+{
+    return !m_dir.empty();
+}
+
+std::filesystem::path CacheSystem::GetEntryPath(const PluginBase& aPlugin, std::span<const uint8_t> aDigest) const
+{
+    std::wstring name;
+    name.reserve(aDigest.size() * 2);
+
+    for (auto byte : aDigest)
+    {
+        fmt::format_to(std::back_inserter(name), L"{:02x}", byte);
+    }
+
+    return m_dir / aPlugin.GetPath().stem() / name;
+}
+
+std::vector<CacheSystem::Entry> CacheSystem::Scan()
+{
+    std::vector<Entry> entries;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(m_paths.GetCacheDir(), error))
+    {
+        if (!entry.is_regular_file(error) || entry.path().extension() == L".tmp")
+        {
+            continue;
+        }
+
+        auto size = entry.file_size(error);
+        if (error)
+        {
+            continue;
+        }
+
+        auto lastUse = entry.last_write_time(error);
+        if (error)
+        {
+            continue;
+        }
+
+        entries.push_back({entry.path(), lastUse, size});
+    }
+
+    return entries;
+}
+
+void CacheSystem::Evict()
+{
+    // Entries of other game versions are part of the same budget, they are never used and go first.
+    auto entries = Scan();
+
+    m_size = 0;
+    for (const auto& entry : entries)
+    {
+        m_size += entry.size;
+    }
+
+    if (m_size <= m_budget)
+    {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& aLhs, const Entry& aRhs) { return aLhs.lastUse < aRhs.lastUse; });
+
+    // Leave some headroom so the next stores do not have to evict right away.
+    const auto target = m_budget / 10 * 9;
+
+    size_t count = 0;
+    for (const auto& entry : entries)
+    {
+        if (m_size <= target)
+        {
+            break;
+        }
+
+        std::error_code error;
+        if (std::filesystem::remove(entry.path, error))
+        {
+            m_size -= entry.size;
+            count++;
+        }
+    }
+
+    Log::debug("Evicted {} cache entr{}, {} byte(s) remain", count, count == 1 ? "y" : "ies", m_size);
+}
+
+RED4EXT_C_EXPORT void* RED4EXT_CALL RED4ext_CacheOpen(RED4ext::PluginHandle aHandle, const uint8_t* aDigest,
+                                                      size_t aDigestSize, const void** aData, size_t* aSize)
+{
+    auto app = App::Get();
+    if (!app || !aDigest || !aData || !aSize)
+    {
+        return nullptr;
+    }
+
+    auto plugin = app->GetPluginSystem()->GetPlugin(aHandle);
+    if (!plugin)
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return nullptr;
+    }
+
+    auto file = app->GetCacheSystem()->Open(*plugin, {aDigest, aDigestSize});
+    if (!file)
+    {
+        return nullptr;
+    }
+
+    *aData = file->GetData();
+    *aSize = file->GetSize();
+
+    return file.release();
+}
+
+RED4EXT_C_EXPORT void RED4EXT_CALL RED4ext_CacheClose(void* aEntry)
+{
+    delete static_cast<MappedFile*>(aEntry);
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_CacheStore(RED4ext::PluginHandle aHandle, const uint8_t* aDigest,
+                                                      size_t aDigestSize, const void* aData, size_t aSize)
+{
+    auto app = App::Get();
+    if (!app || !aDigest || (!aData && aSize > 0))
+    {
+        return false;
+    }
+
+    auto plugin = app->GetPluginSystem()->GetPlugin(aHandle);
+    if (!plugin)
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return false;
+    }
+
+    return app->GetCacheSystem()->Store(*plugin, {aDigest, aDigestSize}, {static_cast<const uint8_t*>(aData), aSize});
+}
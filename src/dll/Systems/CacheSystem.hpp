@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Config.hpp"
+#include "ISystem.hpp"
+#include "MappedFile.hpp"
+#include "Paths.hpp"
+#include "PluginBase.hpp"
+#include "ProfiledMutex.hpp"
+
+#include <span>
+
+/*
+ * Content-addressed cache for data derived by plugins. Entries are keyed by the game version, the plugin and a digest of
+ * the inputs supplied by the plugin, and are evicted least recently used first once the cache exceeds its size budget.
+ */
+class CacheSystem : public ISystem
+{
+public:
+    static constexpr size_t MaxDigestSize = 64;
+
+    CacheSystem(const Config::CacheConfig& aConfig, const Paths& aPaths);
+
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+    std::unique_ptr<MappedFile> Open(const PluginBase& aPlugin, std::span<const uint8_t> aDigest);
+    bool Store(const PluginBase& aPlugin, std::span<const uint8_t> aDigest, std::span<const uint8_t> aData);
+
+private:
+    struct Entry
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUse;
+        uintmax_t size;
+    };
+
+    bool IsEnabled() const;
+    std::filesystem::path GetEntryPath(const PluginBase& aPlugin, std::span<const uint8_t> aDigest) const;
+
+    std::vector<Entry> Scan();
+    void Evict();
+
+    const Paths& m_paths;
+
+    std::filesystem::path m_dir;
+    uintmax_t m_budget;
+
+    ProfiledMutex m_mutex{"cache"};
+    uintmax_t m_size;
+    uint64_t m_nextTemporary;
+};
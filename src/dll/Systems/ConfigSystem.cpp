@@ -0,0 +1,334 @@
+#include "stdafx.hpp"
+#include "ConfigSystem.hpp"
+#include "App.hpp"
+#include "Threading.hpp"
+#include "Utils.hpp"
+
+#include <cstring>
+
+namespace
+{
+constexpr auto PollInterval = std::chrono::seconds(1);
+
+template<typename T>
+bool GetPluginValue(RED4ext::PluginHandle aHandle, const char* aKey, T& aValue)
+{
+    auto app = App::Get();
+    if (!app || !aKey)
+    {
+        return false;
+    }
+
+    auto plugin = app->GetPluginSystem()->GetPlugin(aHandle);
+    if (!plugin)
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return false;
+    }
+
+    const auto name = Utils::ToString(plugin->GetPath().stem());
+
+    auto snapshot = app->GetConfigSystem()->GetSnapshot();
+    auto value = snapshot->FindPluginValue(name, aKey);
+    if (!value)
+    {
+        return false;
+    }
+
+    try
+    {
+        aValue = toml::get<T>(*value);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+} // namespace
+
+const toml::value* ConfigSystem::Snapshot::FindPluginValue(std::string_view aPlugin, std::string_view aKey) const
+{
+    const toml::value* current = &document;
+    for (auto key : {std::string_view("plugins"), aPlugin, aKey})
+    {
+        if (!current->is_table())
+        {
+            return nullptr;
+        }
+
+        const auto& table = current->as_table();
+
+        auto it = table.find(std::string(key));
+        if (it == table.end())
+        {
+            return nullptr;
+        }
+
+        current = &it->second;
+    }
+
+    return current;
+}
+
+ConfigSystem::ConfigSystem(const Config& aConfig, const Paths& aPaths)
+    : m_config(aConfig)
+    , m_paths(aPaths)
+    , m_current(nullptr)
+    , m_isStopping(false)
+    , m_nextId(1)
+{
+}
+
+ESystemType ConfigSystem::GetType()
+{
+    return ESystemType::Config;
+}
+
+void ConfigSystem::Startup()
+{
+    auto snapshot = Load();
+    if (!snapshot)
+    {
+        // 'Config' already loaded the file successfully (or exited), fall back to what it has.
+        snapshot = std::make_unique<Snapshot>();
+        snapshot->logging = m_config.GetLogging();
+        snapshot->plugins = m_config.GetPlugins();
+    }
+
+    snapshot->generation = 0;
+
+    m_current.store(snapshot.get(), std::memory_order_release);
+    m_snapshots.push_back(std::move(snapshot));
+
+    m_watcher = Threading::Start("RED4ext Config", Threading::Priority::Background, &ConfigSystem::Watch, this);
+}
+
+void ConfigSystem::Shutdown()
+{
+    {
+        auto _ = m_watcherMutex.Lock();
+        m_isStopping = true;
+    }
+
+    m_watcherCondition.notify_all();
+    if (m_watcher.joinable())
+    {
+        m_watcher.join();
+    }
+
+    auto _ = m_subscribersMutex.Lock();
+    m_subscribers.clear();
+}
+
+const ConfigSystem::Snapshot* ConfigSystem::GetSnapshot() const
+{
+    return m_current.load(std::memory_order_acquire);
+}
+
+uint64_t ConfigSystem::Subscribe(HMODULE aModule, Callback_t aCallback)
+{
+    auto _ = m_subscribersMutex.Lock();
+
+    auto id = m_nextId++;
+    m_subscribers.emplace(id, Subscriber{aModule, std::move(aCallback)});
+
+    return id;
+}
+
+void ConfigSystem::Unsubscribe(uint64_t aId)
+{
+    auto _ = m_subscribersMutex.Lock();
+    m_subscribers.erase(aId);
+}
+
+void ConfigSystem::Unsubscribe(HMODULE aModule)
+{
+    {
+        auto _ = m_subscribersMutex.Lock();
+        std::erase_if(m_subscribers, [aModule](const auto& aItem) { return aItem.second.module == aModule; });
+    }
+
+    // Wait for a notification that might still call into the module.
+    auto _ = m_notifyMutex.Lock();
+}
+
+void ConfigSystem::ApplyLogging(spdlog::logger& aLogger) const
+{
+    auto snapshot = GetSnapshot();
+    if (!snapshot)
+    {
+        return;
+    }
+
+    aLogger.set_level(snapshot->logging.level);
+    aLogger.flush_on(snapshot->logging.flushOn);
+}
+
+void ConfigSystem::Watch()
+{
+    auto lock = m_watcherMutex.Lock();
+    while (!m_watcherCondition.wait_for(lock, PollInterval, [this]() { return m_isStopping; }))
+    {
+        lock.unlock();
+
+        auto snapshot = Load();
+        if (snapshot)
+        {
+            Publish(std::move(snapshot));
+        }
+
+        lock.lock();
+    }
+}
+
+std::unique_ptr<ConfigSystem::Snapshot> ConfigSystem::Load()
+{
+    const auto file = m_paths.GetConfigFile();
+
+    std::error_code error;
+    auto lastWrite = std::filesystem::last_write_time(file, error);
+    if (error || lastWrite == m_lastWrite)
+    {
+        return nullptr;
+    }
+
+    m_lastWrite = lastWrite;
+
+    auto snapshot = std::make_unique<Snapshot>();
+    try
+    {
+        snapshot->document = toml::parse(file);
+        snapshot->logging.LoadV0(snapshot->document);
+        snapshot->plugins.LoadV0(snapshot->document);
+    }
+    catch (const std::exception& e)
+    {
+        Log::warn("Could not parse the config file, the current configuration is kept. Error: {}", e.what());
+        return nullptr;
+    }
+
+    return snapshot;
+}
+
+void ConfigSystem::Publish(std::unique_ptr<Snapshot> aSnapshot)
+{
+    auto previous = GetSnapshot();
+    auto snapshot = aSnapshot.get();
+
+    snapshot->generation = previous->generation + 1;
+
+    m_snapshots.push_back(std::move(aSnapshot));
+    m_current.store(snapshot, std::memory_order_release);
+
+    Log::info("The config file was reloaded (generation {})", snapshot->generation);
+
+    if (previous->logging.level != snapshot->logging.level || previous->logging.flushOn != snapshot->logging.flushOn)
+    {
+        spdlog::apply_all([this](std::shared_ptr<spdlog::logger> aLogger) { ApplyLogging(*aLogger); });
+        Log::info("Logging level set to '{}', flushing on '{}'", spdlog::level::to_string_view(snapshot->logging.level),
+                  spdlog::level::to_string_view(snapshot->logging.flushOn));
+    }
+
+    auto notify = m_notifyMutex.Lock();
+
+    std::vector<Callback_t> callbacks;
+    {
+        auto _ = m_subscribersMutex.Lock();
+
+        callbacks.reserve(m_subscribers.size());
+        for (const auto& [id, subscriber] : m_subscribers)
+        {
+            callbacks.push_back(subscriber.callback);
+        }
+    }
+
+    for (const auto& callback : callbacks)
+    {
+        try
+        {
+            callback(*snapshot);
+        }
+        catch (const std::exception& e)
+        {
+            Log::warn("An exception occured while notifying a config subscriber");
+            Log::warn(e.what());
+        }
+        catch (...)
+        {
+            Log::warn("An unknown exception occured while notifying a config subscriber");
+        }
+    }
+}
+
+RED4EXT_C_EXPORT uint64_t RED4EXT_CALL RED4ext_ConfigSubscribe(RED4ext::PluginHandle aHandle,
+                                                               void(RED4EXT_CALL* aCallback)(void* aUserData),
+                                                               void* aUserData)
+{
+    auto app = App::Get();
+    if (!app || !aCallback)
+    {
+        return 0;
+    }
+
+    if (!app->GetPluginSystem()->GetPlugin(aHandle))
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return 0;
+    }
+
+    auto configSystem = app->GetConfigSystem();
+    return configSystem->Subscribe(aHandle, [aCallback, aUserData](const ConfigSystem::Snapshot&)
+                                   { aCallback(aUserData); });
+}
+
+RED4EXT_C_EXPORT void RED4EXT_CALL RED4ext_ConfigUnsubscribe(uint64_t aId)
+{
+    auto app = App::Get();
+    if (!app)
+    {
+        return;
+    }
+
+    app->GetConfigSystem()->Unsubscribe(aId);
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_ConfigGetBool(RED4ext::PluginHandle aHandle, const char* aKey,
+                                                         bool* aValue)
+{
+    return aValue && GetPluginValue(aHandle, aKey, *aValue);
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_ConfigGetInt(RED4ext::PluginHandle aHandle, const char* aKey,
+                                                        int64_t* aValue)
+{
+    return aValue && GetPluginValue(aHandle, aKey, *aValue);
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_ConfigGetFloat(RED4ext::PluginHandle aHandle, const char* aKey,
+                                                          double* aValue)
+{
+    return aValue && GetPluginValue(aHandle, aKey, *aValue);
+}
+
+// 'aSize' is the size of the buffer on input and the size required for the value (including the terminator) on output.
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_ConfigGetString(RED4ext::PluginHandle aHandle, const char* aKey,
+                                                           char* aBuffer, size_t* aSize)
+{
+    std::string value;
+    if (!aSize || !GetPluginValue(aHandle, aKey, value))
+    {
+        return false;
+    }
+
+    auto capacity = *aSize;
+    *aSize = value.size() + 1;
+
+    if (!aBuffer || capacity < *aSize)
+    {
+        return false;
+    }
+
+    std::memcpy(aBuffer, value.c_str(), *aSize);
+    return true;
+}
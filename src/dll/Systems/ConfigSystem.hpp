@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Config.hpp"
+#include "ISystem.hpp"
+#include "Paths.hpp"
+#include "ProfiledMutex.hpp"
+
+#include <condition_variable>
+#include <functional>
+
+/*
+ * Live view of the config file. The file is watched and parsed on a background thread, every successful parse is
+ * published as an immutable snapshot through an atomic pointer swap, so readers never take a lock. Snapshots are never
+ * freed while the system is running (reloads are rare and snapshots are small), which keeps every pointer handed out
+ * by 'GetSnapshot' valid without reference counting.
+ */
+class ConfigSystem : public ISystem
+{
+public:
+    struct Snapshot
+    {
+        // Returns the value of 'aKey' in the plugin's section ('[plugins.<name>]'), or null if there is none.
+        const toml::value* FindPluginValue(std::string_view aPlugin, std::string_view aKey) const;
+
+        uint64_t generation;
+        toml::value document;
+        Config::LoggingConfig logging;
+        Config::PluginsConfig plugins;
+    };
+
+    using Callback_t = std::function<void(const Snapshot&)>;
+
+    ConfigSystem(const Config& aConfig, const Paths& aPaths);
+
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+    const Snapshot* GetSnapshot() const;
+
+    // Callbacks are invoked from the watcher thread after a new snapshot is published.
+    uint64_t Subscribe(HMODULE aModule, Callback_t aCallback);
+    void Unsubscribe(uint64_t aId);
+    void Unsubscribe(HMODULE aModule);
+
+    void ApplyLogging(spdlog::logger& aLogger) const;
+
+private:
+    struct Subscriber
+    {
+        HMODULE module;
+        Callback_t callback;
+    };
+
+    void Watch();
+    std::unique_ptr<Snapshot> Load();
+    void Publish(std::unique_ptr<Snapshot> aSnapshot);
+
+    const Config& m_config;
+    const Paths& m_paths;
+
+    std::atomic<const Snapshot*> m_current;
+    std::vector<std::unique_ptr<const Snapshot>> m_snapshots;
+    std::filesystem::file_time_type m_lastWrite;
+
+    std::thread m_watcher;
+    ProfiledMutex m_watcherMutex{"config.watcher"};
+    std::condition_variable_any m_watcherCondition;
+    bool m_isStopping;
+
+    ProfiledMutex m_subscribersMutex{"config.subscribers"};
+    std::map<uint64_t, Subscriber> m_subscribers;
+    uint64_t m_nextId;
+
+    // Held while subscribers are notified, so unsubscribing a module waits for its running callbacks.
+    ProfiledMutex m_notifyMutex{"config.notify"};
+};
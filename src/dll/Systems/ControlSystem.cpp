@@ -0,0 +1,691 @@
+#include "stdafx.hpp"
+#include "ControlSystem.hpp"
+#include "App.hpp"
+#include "Hooks/HookTable.hpp"
+#include "Platform/FridaHookCounters.hpp"
+#include "Threading.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <ranges>
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr size_t MaxRequestLength = 1024;
+constexpr size_t MaxClients = 8;
+constexpr auto ClientTimeout = std::chrono::seconds(30);
+constexpr auto MaxCaptureDuration = std::chrono::seconds(300);
+
+constexpr auto Usage = "help                         - lists the commands\n"
+                       "plugins                      - lists the loaded plugins\n"
+                       "hooks                        - lists the built-in hooks and the hooks attached by plugins\n"
+                       "metrics [prefix]             - prints the metrics, or the ones starting with the prefix\n"
+                       "locks                        - prints the lock statistics and the call sites that waited\n"
+                       "log <logger> <level|default> - sets the level of the 'RED4ext' or a plugin's logger\n"
+                       "instrument <on|off>          - counts the calls and the time spent in the built-in hooks\n"
+                       "diagnostics <on|off> [hooks] - attaches or detaches the diagnostic hooks, all by default\n"
+                       "trace <seconds>              - logs everything and flushes every message for a while\n"
+                       "profile <seconds>            - prints what the built-in hooks and the locks cost for a while\n";
+
+std::optional<std::chrono::seconds> ParseDuration(std::string_view aText)
+{
+    uint32_t seconds = 0;
+
+    auto [end, error] = std::from_chars(aText.data(), aText.data() + aText.size(), seconds);
+    if (error != std::errc() || end != aText.data() + aText.size() || seconds == 0 ||
+        std::chrono::seconds(seconds) > MaxCaptureDuration)
+    {
+        return std::nullopt;
+    }
+
+    return std::chrono::seconds(seconds);
+}
+} // namespace
+
+ControlSystem::ControlSystem(const Config::DevConfig& aConfig)
+    : m_config(aConfig)
+    , m_socket(-1)
+    , m_wakeup{-1, -1}
+    , m_isStopping(false)
+    , m_isTracing(false)
+    , m_isProfiling(false)
+{
+}
+
+ESystemType ControlSystem::GetType()
+{
+    return ESystemType::Control;
+}
+
+void ControlSystem::Startup()
+{
+    if (!m_config.hasControlSocket)
+    {
+        return;
+    }
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    std::error_code error;
+    auto dir = std::filesystem::temp_directory_path(error);
+    if (error)
+    {
+        dir = "/tmp";
+    }
+
+    m_path = dir / fmt::format("red4ext-{}.sock", getpid());
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    const auto path = m_path.string();
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        Log::warn("The control socket path '{}' is too long, the control server is disabled", path);
+        return;
+    }
+
+    std::ranges::copy(path, address.sun_path);
+
+    m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socket < 0)
+    {
+        Log::warn("Could not create the control socket, the control server is disabled. Error: {}", errno);
+        return;
+    }
+
+    // The path has the process id in it, a file that is already there was left by a process that died.
+    unlink(path.c_str());
+
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0 || listen(m_socket, 4) != 0 || pipe(m_wakeup) != 0)
+    {
+        Log::warn("Could not listen on the control socket '{}', the control server is disabled. Error: {}", path,
+                  errno);
+
+        close(m_socket);
+        m_socket = -1;
+
+        unlink(path.c_str());
+        return;
+    }
+
+    m_thread = Threading::Start("RED4ext Control", Threading::Priority::Background, &ControlSystem::Serve, this);
+    Log::info("The control server is listening on '{}'", path);
+#else
+    Log::debug("The control server is not available on this platform");
+#endif
+}
+
+void ControlSystem::Shutdown()
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    if (m_socket < 0)
+    {
+        return;
+    }
+
+    {
+        auto _ = m_mutex.Lock();
+        m_isStopping = true;
+    }
+
+    m_condition.notify_all();
+
+    char wakeup = 0;
+    write(m_wakeup[1], &wakeup, sizeof(wakeup));
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    // The clients see the wake-up pipe and the captures see 'm_isStopping', they all return.
+    JoinClients(true);
+
+    close(m_socket);
+    close(m_wakeup[0]);
+    close(m_wakeup[1]);
+
+    m_socket = -1;
+    unlink(m_path.string().c_str());
+#endif
+}
+
+void ControlSystem::Serve()
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    while (true)
+    {
+        pollfd fds[] = {{m_socket, POLLIN, 0}, {m_wakeup[0], POLLIN, 0}};
+        if (poll(fds, std::size(fds), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            Log::warn("The control server stopped unexpectedly. Error: {}", errno);
+            return;
+        }
+
+        if (fds[1].revents != 0)
+        {
+            return;
+        }
+
+        auto client = accept(m_socket, nullptr, nullptr);
+        if (client < 0)
+        {
+            continue;
+        }
+
+        // A client that goes away must not kill the game with SIGPIPE.
+        int32_t noSigPipe = 1;
+        setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+
+        JoinClients(false);
+        if (m_clients.size() >= MaxClients)
+        {
+            constexpr std::string_view busy = "ERR too many clients\n";
+            send(client, busy.data(), busy.size(), 0);
+            close(client);
+
+            continue;
+        }
+
+        auto& state = m_clients.emplace_back();
+        state.thread = Threading::Start("RED4ext Control Client", Threading::Priority::Background,
+                                        [this, client, &state]()
+                                        {
+                                            ServeClient(client);
+                                            close(client);
+
+                                            state.isDone = true;
+                                        });
+    }
+#endif
+}
+
+void ControlSystem::JoinClients(bool aAll)
+{
+    for (auto it = m_clients.begin(); it != m_clients.end();)
+    {
+        if (!aAll && !it->isDone)
+        {
+            ++it;
+            continue;
+        }
+
+        it->thread.join();
+        it = m_clients.erase(it);
+    }
+}
+
+void ControlSystem::ServeClient(int32_t aClient)
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    std::string buffer;
+    char chunk[256];
+
+    while (true)
+    {
+        auto end = buffer.find('\n');
+        if (end == std::string::npos)
+        {
+            if (buffer.size() > MaxRequestLength)
+            {
+                return;
+            }
+
+            pollfd fds[] = {{aClient, POLLIN, 0}, {m_wakeup[0], POLLIN, 0}};
+
+            const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(ClientTimeout).count();
+            if (poll(fds, std::size(fds), static_cast<int>(timeout)) <= 0 || fds[1].revents != 0)
+            {
+                return;
+            }
+
+            auto count = recv(aClient, chunk, sizeof(chunk), 0);
+            if (count <= 0)
+            {
+                return;
+            }
+
+            buffer.append(chunk, static_cast<size_t>(count));
+            continue;
+        }
+
+        std::string_view request(buffer.data(), end);
+        if (request.ends_with('\r'))
+        {
+            request.remove_suffix(1);
+        }
+
+        auto response = Execute(request);
+        buffer.erase(0, end + 1);
+
+        auto output = std::move(response.body);
+        output += response.error.empty() ? "OK\n" : fmt::format("ERR {}\n", response.error);
+
+        // A client that does not read its response must not keep the thread, and the game, from exiting.
+        std::string_view remaining = output;
+        while (!remaining.empty())
+        {
+            pollfd fds[] = {{aClient, POLLOUT, 0}, {m_wakeup[0], POLLIN, 0}};
+
+            const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(ClientTimeout).count();
+            if (poll(fds, std::size(fds), static_cast<int>(timeout)) <= 0 || fds[1].revents != 0 ||
+                (fds[0].revents & POLLOUT) == 0)
+            {
+                return;
+            }
+
+            auto count = send(aClient, remaining.data(), remaining.size(), MSG_DONTWAIT);
+            if (count < 0 && errno == EAGAIN)
+            {
+                continue;
+            }
+
+            if (count <= 0)
+            {
+                return;
+            }
+
+            remaining.remove_prefix(static_cast<size_t>(count));
+        }
+    }
+#else
+    RED4EXT_UNUSED_PARAMETER(aClient);
+#endif
+}
+
+ControlSystem::Response ControlSystem::Execute(std::string_view aRequest)
+{
+    Args_t args;
+    for (const auto part : std::views::split(aRequest, ' '))
+    {
+        if (!part.empty())
+        {
+            args.emplace_back(&*part.begin(), static_cast<size_t>(std::ranges::distance(part)));
+        }
+    }
+
+    Response response;
+    if (args.empty())
+    {
+        response.error = "empty request";
+        return response;
+    }
+
+    const auto command = args.front();
+    args.erase(args.begin());
+
+    Log::debug("Control request: {}", aRequest);
+
+    try
+    {
+        if (command == "help")
+        {
+            Help(args, response);
+        }
+        else if (command == "plugins")
+        {
+            ListPlugins(args, response);
+        }
+        else if (command == "hooks")
+        {
+            ListHooks(args, response);
+        }
+        else if (command == "metrics")
+        {
+            ListMetrics(args, response);
+        }
+        else if (command == "locks")
+        {
+            ListLocks(args, response);
+        }
+        else if (command == "log")
+        {
+            SetLogLevel(args, response);
+        }
+        else if (command == "instrument")
+        {
+            SetInstrumentation(args, response);
+        }
+        else if (command == "diagnostics")
+        {
+            SetDiagnostics(args, response);
+        }
+        else if (command == "trace")
+        {
+            CaptureTrace(args, response);
+        }
+        else if (command == "profile")
+        {
+            CaptureProfile(args, response);
+        }
+        else
+        {
+            response.error = fmt::format("unknown command '{}', see 'help'", command);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        response.body.clear();
+        response.error = e.what();
+    }
+
+    return response;
+}
+
+void ControlSystem::Help(const Args_t&, Response& aResponse)
+{
+    aResponse.body = Usage;
+}
+
+void ControlSystem::ListPlugins(const Args_t&, Response& aResponse)
+{
+    auto plugins = App::Get()->GetPluginSystem()->GetPlugins();
+    std::ranges::sort(plugins, std::less{}, [](const auto& aPlugin) { return aPlugin->GetName(); });
+
+    for (const auto& plugin : plugins)
+    {
+        aResponse.body += fmt::format("{} {} ({}) {}\n", plugin->GetName(), std::to_string(plugin->GetVersion()),
+                                      plugin->GetAuthor(), Utils::ToString(plugin->GetPath()));
+    }
+}
+
+void ControlSystem::ListHooks(const Args_t&, Response& aResponse)
+{
+    for (const auto& hook : Hooks::GetStatus())
+    {
+        const auto kind = hook.isRequired ? "required" : hook.isDiagnostic ? "diagnostic" : "optional";
+        aResponse.body +=
+            fmt::format("built-in {} {} {}", hook.name, hook.isAttached ? "attached" : "detached", kind);
+        if (hook.isInstrumentable)
+        {
+            const auto time = std::chrono::duration_cast<std::chrono::microseconds>(hook.time).count();
+            aResponse.body += fmt::format(" calls={} time_us={}", hook.calls, time);
+        }
+
+        aResponse.body += '\n';
+    }
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    for (const auto& counter : FridaHookCounters::Collect())
+    {
+        aResponse.body += fmt::format("frida {} calls={}\n", counter.name, counter.calls);
+    }
+#endif
+
+    for (const auto& hook : App::Get()->GetHookingSystem()->GetHooks())
+    {
+        const auto plugin = hook.plugin->GetName();
+        if (hook.symbol)
+        {
+            aResponse.body += fmt::format("plugin {} symbol={}\n", plugin, hook.symbol);
+        }
+        else
+        {
+            aResponse.body += fmt::format("plugin {} target={}\n", plugin, hook.target);
+        }
+    }
+}
+
+void ControlSystem::ListMetrics(const Args_t& aArgs, Response& aResponse)
+{
+    const auto prefix = aArgs.empty() ? std::string_view() : aArgs.front();
+
+    for (const auto& sample : App::Get()->GetMetricsSystem()->Collect())
+    {
+        if (sample.name.starts_with(prefix))
+        {
+            aResponse.body += fmt::format("{} {} {}\n", sample.name, sample.value, sample.peak);
+        }
+    }
+}
+
+void ControlSystem::ListLocks(const Args_t&, Response& aResponse)
+{
+    using namespace std::chrono;
+
+    for (const auto& lock : ProfiledMutex::Collect())
+    {
+        aResponse.body += fmt::format("{} acquisitions={} contentions={} wait_us={} max_wait_us={} hold_ns={}\n",
+                                      lock.name, lock.acquisitions, lock.contentions,
+                                      duration_cast<microseconds>(lock.wait).count(),
+                                      duration_cast<microseconds>(lock.maxWait).count(), lock.hold.count());
+
+        for (const auto& site : lock.sites)
+        {
+            aResponse.body += fmt::format("  {} contentions={} wait_us={}\n", site.location, site.contentions,
+                                          duration_cast<microseconds>(site.wait).count());
+        }
+    }
+}
+
+void ControlSystem::SetLogLevel(const Args_t& aArgs, Response& aResponse)
+{
+    if (aArgs.size() < 2)
+    {
+        aResponse.error = "usage: log <logger> <level|default>";
+        return;
+    }
+
+    // Plugin names can have spaces, the level is the last argument.
+    const auto levelName = aArgs.back();
+    const auto first = aArgs.front();
+    const auto last = aArgs[aArgs.size() - 2];
+    const std::string_view name(first.data(), static_cast<size_t>(last.data() + last.size() - first.data()));
+
+    std::optional<spdlog::level::level_enum> level;
+    if (levelName != "default")
+    {
+        level = spdlog::level::from_str(std::string(levelName));
+
+        // spdlog returns 'off' when there is no match.
+        if (level == spdlog::level::off && levelName != "off")
+        {
+            aResponse.error = fmt::format("unknown level '{}'", levelName);
+            return;
+        }
+    }
+
+    auto plugins = App::Get()->GetPluginSystem()->GetPlugins();
+    auto isPlugin = std::ranges::any_of(plugins, [name](const auto& aPlugin)
+                                        { return aPlugin->GetName() == name; });
+
+    if (name != "RED4ext" && !isPlugin)
+    {
+        aResponse.error = fmt::format("unknown logger '{}'", name);
+        return;
+    }
+
+    App::Get()->GetLoggerSystem()->SetLevel(name, level);
+    Log::info("The level of the '{}' logger was set to '{}' from the control socket", name, levelName);
+}
+
+void ControlSystem::SetInstrumentation(const Args_t& aArgs, Response& aResponse)
+{
+    if (aArgs.size() != 1 || (aArgs.front() != "on" && aArgs.front() != "off"))
+    {
+        aResponse.error = "usage: instrument <on|off>";
+        return;
+    }
+
+    const auto isInstrumented = aArgs.front() == "on";
+    Hooks::SetInstrumented(isInstrumented);
+
+    Log::info("The instrumentation of the built-in hooks was turned {} from the control socket", aArgs.front());
+}
+
+void ControlSystem::SetDiagnostics(const Args_t& aArgs, Response& aResponse)
+{
+    if (aArgs.empty() || (aArgs.front() != "on" && aArgs.front() != "off"))
+    {
+        aResponse.error = "usage: diagnostics <on|off> [hooks...]";
+        return;
+    }
+
+    std::span<const std::string_view> names(aArgs);
+    names = names.subspan(1);
+
+    const auto statuses = Hooks::GetStatus();
+    for (const auto& name : names)
+    {
+        auto isDiagnostic = std::ranges::any_of(statuses, [name](const auto& aStatus)
+                                                { return aStatus.isDiagnostic && aStatus.name == name; });
+        if (!isDiagnostic)
+        {
+            aResponse.error = fmt::format("'{}' is not a diagnostic hook, see 'hooks'", name);
+            return;
+        }
+    }
+
+    if (!Hooks::SetDiagnostics(names, aArgs.front() == "on"))
+    {
+        aResponse.error = "the transaction failed, see the log";
+    }
+}
+
+void ControlSystem::CaptureTrace(const Args_t& aArgs, Response& aResponse)
+{
+    auto duration = aArgs.size() == 1 ? ParseDuration(aArgs.front()) : std::nullopt;
+    if (!duration)
+    {
+        aResponse.error = fmt::format("usage: trace <seconds>, at most {}", MaxCaptureDuration.count());
+        return;
+    }
+
+    // The end of a trace puts the levels back, an overlapping one would end the other early.
+    if (!BeginCapture(m_isTracing))
+    {
+        aResponse.error = "a trace is already being captured";
+        return;
+    }
+
+    auto loggerSystem = App::Get()->GetLoggerSystem();
+
+    Log::info("Capturing a trace for {} second(s)...", duration->count());
+    loggerSystem->BeginTrace();
+
+    auto isComplete = Wait(*duration);
+
+    loggerSystem->ApplyLevels();
+    EndCapture(m_isTracing);
+
+    Log::info("The trace capture has ended");
+
+    if (!isComplete)
+    {
+        aResponse.error = "the capture was interrupted";
+        return;
+    }
+
+    aResponse.body = fmt::format("{}\n", App::Get()->GetPaths()->GetLogsDir().string());
+}
+
+void ControlSystem::CaptureProfile(const Args_t& aArgs, Response& aResponse)
+{
+    using namespace std::chrono;
+
+    auto duration = aArgs.size() == 1 ? ParseDuration(aArgs.front()) : std::nullopt;
+    if (!duration)
+    {
+        aResponse.error = fmt::format("usage: profile <seconds>, at most {}", MaxCaptureDuration.count());
+        return;
+    }
+
+    const auto before = Hooks::GetStatus();
+    const auto locksBefore = ProfiledMutex::Collect();
+
+    // The end of a profile puts the instrumentation back, an overlapping one would turn it off under the other.
+    if (!BeginCapture(m_isProfiling))
+    {
+        aResponse.error = "a profile is already being captured";
+        return;
+    }
+
+    Log::info("Profiling the built-in hooks for {} second(s)...", duration->count());
+
+    const auto wasInstrumented = Hooks::IsInstrumented();
+
+    Hooks::SetInstrumented(true);
+    auto isComplete = Wait(*duration);
+    Hooks::SetInstrumented(wasInstrumented);
+
+    EndCapture(m_isProfiling);
+
+    const auto after = Hooks::GetStatus();
+    const auto locksAfter = ProfiledMutex::Collect();
+
+    Log::info("The profile capture has ended");
+
+    if (!isComplete)
+    {
+        aResponse.error = "the capture was interrupted";
+        return;
+    }
+
+    aResponse.body = fmt::format("{:<32} {:>10} {:>12} {:>12}\n", "hook", "calls", "total us", "avg ns");
+    for (size_t i = 0; i < after.size(); i++)
+    {
+        const auto calls = after[i].calls - before[i].calls;
+        if (calls == 0)
+        {
+            continue;
+        }
+
+        const auto time = after[i].time - before[i].time;
+        aResponse.body += fmt::format("{:<32} {:>10} {:>12} {:>12}\n", after[i].name, calls,
+                                      duration_cast<microseconds>(time).count(), time.count() / calls);
+    }
+
+    aResponse.body += fmt::format("\n{:<32} {:>10} {:>12} {:>12}\n", "lock", "acquired", "contended", "wait us");
+    for (const auto& lock : locksAfter)
+    {
+        auto previous = std::ranges::find(locksBefore, lock.name, &ProfiledMutex::Stats::name);
+        if (previous == locksBefore.end() || lock.acquisitions == previous->acquisitions)
+        {
+            continue;
+        }
+
+        aResponse.body += fmt::format("{:<32} {:>10} {:>12} {:>12}\n", lock.name,
+                                      lock.acquisitions - previous->acquisitions,
+                                      lock.contentions - previous->contentions,
+                                      duration_cast<microseconds>(lock.wait - previous->wait).count());
+    }
+}
+
+bool ControlSystem::BeginCapture(bool& aIsRunning)
+{
+    auto _ = m_mutex.Lock();
+    if (aIsRunning)
+    {
+        return false;
+    }
+
+    aIsRunning = true;
+    return true;
+}
+
+void ControlSystem::EndCapture(bool& aIsRunning)
+{
+    auto _ = m_mutex.Lock();
+    aIsRunning = false;
+}
+
+bool ControlSystem::Wait(std::chrono::seconds aDuration)
+{
+    auto lock = m_mutex.Lock();
+    return !m_condition.wait_for(lock, aDuration, [this]() { return m_isStopping; });
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Config.hpp"
+#include "ISystem.hpp"
+#include "ProfiledMutex.hpp"
+
+#include <condition_variable>
+
+/*
+ * Local control server for runtime introspection and tuning, 'red4ext-ctl' is its client. It listens on a Unix domain
+ * socket only the user can connect to, '<temp dir>/red4ext-<pid>.sock', and serves each client on its own background
+ * thread, so a long capture does not hold the other clients up. Only one trace and one profile run at a time.
+ *
+ * The protocol is line based: a request is one line, '<command> [arguments...]', and the response is any number of
+ * lines followed by a status line, 'OK' or 'ERR <reason>'. A client can send several requests over one connection.
+ */
+class ControlSystem : public ISystem
+{
+public:
+    ControlSystem(const Config::DevConfig& aConfig);
+
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+private:
+    using Args_t = std::vector<std::string_view>;
+
+    struct Response
+    {
+        std::string body;
+        std::string error;
+    };
+
+    struct Client
+    {
+        std::thread thread;
+        std::atomic_bool isDone{false};
+    };
+
+    void Serve();
+    void ServeClient(int32_t aClient);
+
+    // Joins the threads of the clients that are done, or of all the clients.
+    void JoinClients(bool aAll);
+
+    Response Execute(std::string_view aRequest);
+
+    void Help(const Args_t& aArgs, Response& aResponse);
+    void ListPlugins(const Args_t& aArgs, Response& aResponse);
+    void ListHooks(const Args_t& aArgs, Response& aResponse);
+    void ListMetrics(const Args_t& aArgs, Response& aResponse);
+    void ListLocks(const Args_t& aArgs, Response& aResponse);
+    void SetLogLevel(const Args_t& aArgs, Response& aResponse);
+    void SetInstrumentation(const Args_t& aArgs, Response& aResponse);
+    void SetDiagnostics(const Args_t& aArgs, Response& aResponse);
+    void CaptureTrace(const Args_t& aArgs, Response& aResponse);
+    void CaptureProfile(const Args_t& aArgs, Response& aResponse);
+
+    // Claims the capture the flag stands for, returns false if another client is running it.
+    bool BeginCapture(bool& aIsRunning);
+    void EndCapture(bool& aIsRunning);
+
+    // Waits for the duration of a capture, returns false if the system is shutting down.
+    bool Wait(std::chrono::seconds aDuration);
+
+    const Config::DevConfig& m_config;
+    std::filesystem::path m_path;
+
+    int32_t m_socket;
+    int32_t m_wakeup[2];
+
+    std::thread m_thread;
+
+    // Only touched by the server thread, and by 'Shutdown' once it has stopped.
+    std::list<Client> m_clients;
+
+    ProfiledMutex m_mutex{"control"};
+    std::condition_variable_any m_condition;
+    bool m_isStopping;
+    bool m_isTracing;
+    bool m_isProfiling;
+};
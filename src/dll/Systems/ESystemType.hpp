@@ -7,8 +7,16 @@ enum class ESystemType : uint8_t
      */
 
     Logger,
+    Metrics,
+    Allocator,
+    Io,
+    Cache,
+    Config,
+    Event,
+    Snapshot,
     Hooking,
     Script,
     State,
-    Plugin
+    Plugin,
+    Control
 };
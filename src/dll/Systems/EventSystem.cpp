@@ -0,0 +1,155 @@
+#include "stdafx.hpp"
+#include "EventSystem.hpp"
+#include "App.hpp"
+
+#include <algorithm>
+
+EventSystem::EventSystem()
+{
+    auto empty = std::make_unique<const Listeners>();
+    for (auto& listeners : m_listeners)
+    {
+        listeners.store(empty.get(), std::memory_order_relaxed);
+    }
+
+    m_arrays.push_back(std::move(empty));
+}
+
+ESystemType EventSystem::GetType()
+{
+    return ESystemType::Event;
+}
+
+void EventSystem::Startup()
+{
+}
+
+void EventSystem::Shutdown()
+{
+    auto _ = m_mutex.Lock();
+
+    auto empty = m_arrays.front().get();
+    for (auto& listeners : m_listeners)
+    {
+        listeners.store(empty, std::memory_order_release);
+    }
+}
+
+bool EventSystem::Subscribe(HMODULE aModule, EEventType aType, Listener_t aListener, void* aUserData)
+{
+    if (aType >= EEventType::Count || !aListener)
+    {
+        return false;
+    }
+
+    auto _ = m_mutex.Lock();
+
+    auto listeners = std::make_unique<Listeners>(*m_listeners[static_cast<size_t>(aType)].load());
+    listeners->push_back({aModule, aListener, aUserData});
+
+    Replace(aType, std::move(listeners));
+    return true;
+}
+
+bool EventSystem::Unsubscribe(HMODULE aModule, EEventType aType, Listener_t aListener, void* aUserData)
+{
+    if (aType >= EEventType::Count)
+    {
+        return false;
+    }
+
+    auto _ = m_mutex.Lock();
+
+    const auto& current = *m_listeners[static_cast<size_t>(aType)].load();
+    auto it = std::find_if(current.begin(), current.end(),
+                           [aModule, aListener, aUserData](const Listener& aItem) {
+                               return aItem.module == aModule && aItem.func == aListener &&
+                                      aItem.userData == aUserData;
+                           });
+
+    if (it == current.end())
+    {
+        return false;
+    }
+
+    auto listeners = std::make_unique<Listeners>(current);
+    listeners->erase(listeners->begin() + std::distance(current.begin(), it));
+
+    Replace(aType, std::move(listeners));
+    return true;
+}
+
+void EventSystem::Unsubscribe(HMODULE aModule)
+{
+    auto _ = m_mutex.Lock();
+
+    for (size_t i = 0; i < EventCount; i++)
+    {
+        const auto& current = *m_listeners[i].load();
+
+        auto isOwned = [aModule](const Listener& aItem) { return aItem.module == aModule; };
+        if (std::none_of(current.begin(), current.end(), isOwned))
+        {
+            continue;
+        }
+
+        auto listeners = std::make_unique<Listeners>(current);
+        std::erase_if(*listeners, isOwned);
+
+        Replace(static_cast<EEventType>(i), std::move(listeners));
+    }
+}
+
+void EventSystem::Emit(EEventType aType, const void* aEvent)
+{
+    const auto& listeners = *m_listeners[static_cast<size_t>(aType)].load(std::memory_order_acquire);
+    for (const auto& listener : listeners)
+    {
+        try
+        {
+            listener.func(listener.userData, aEvent);
+        }
+        catch (...)
+        {
+            auto plugin = App::Get()->GetPluginSystem()->GetPlugin(listener.module);
+            Log::warn("An exception occured in the listener for event {} registered by '{}'",
+                      static_cast<uint32_t>(aType), plugin ? plugin->GetName() : "<unknown>");
+        }
+    }
+}
+
+void EventSystem::Replace(EEventType aType, std::unique_ptr<const Listeners> aListeners)
+{
+    m_listeners[static_cast<size_t>(aType)].store(aListeners.get(), std::memory_order_release);
+    m_arrays.push_back(std::move(aListeners));
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_SubscribeEvent(RED4ext::PluginHandle aHandle, uint32_t aType,
+                                                          EventSystem::Listener_t aListener, void* aUserData)
+{
+    auto app = App::Get();
+    if (!app)
+    {
+        return false;
+    }
+
+    if (!app->GetPluginSystem()->GetPlugin(aHandle))
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return false;
+    }
+
+    return app->GetEventSystem()->Subscribe(aHandle, static_cast<EEventType>(aType), aListener, aUserData);
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_UnsubscribeEvent(RED4ext::PluginHandle aHandle, uint32_t aType,
+                                                            EventSystem::Listener_t aListener, void* aUserData)
+{
+    auto app = App::Get();
+    if (!app)
+    {
+        return false;
+    }
+
+    return app->GetEventSystem()->Unsubscribe(aHandle, static_cast<EEventType>(aType), aListener, aUserData);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "ISystem.hpp"
+#include "ProfiledMutex.hpp"
+
+#include <array>
+
+/*
+ * Events raised from RED4ext's own detours, so plugins do not have to hook the same functions again. The payloads are
+ * plain structs and part of the plugin-facing ABI of 'RED4ext_SubscribeEvent', the index of a type in 'EEventType' is
+ * its id.
+ */
+enum class EEventType : uint32_t
+{
+    GameStateAdded,
+    ScriptsInitialized,
+    ScriptsLoaded,
+    ProcessExecuting,
+    ScriptsValidated,
+    SaveableSystemsCollected,
+    SessionError,
+
+    Count
+};
+
+namespace Events
+{
+struct GameStateAdded
+{
+    RED4ext::CGameApplication* app;
+    RED4ext::IGameState* state;
+};
+
+struct ScriptsInitialized
+{
+    RED4ext::CBaseEngine* engine;
+    const char* blobPath;
+};
+
+struct ScriptsLoaded
+{
+    RED4ext::CBaseEngine* engine;
+    const char* blobPath;
+    bool succeeded;
+};
+
+struct ProcessExecuting
+{
+    const char* command;
+};
+
+struct ScriptsValidated
+{
+    uint32_t errorCount;
+    bool succeeded;
+};
+
+struct SaveableSystemsCollected
+{
+    const RED4ext::DynArray<RED4ext::Handle<RED4ext::IScriptable>>* systems;
+};
+
+struct SessionError
+{
+    uint32_t code;
+};
+
+template<typename T>
+struct Traits;
+
+#define RED4EXT_DECLARE_EVENT(name)                                                                                    \
+    template<>                                                                                                         \
+    struct Traits<name>                                                                                                \
+    {                                                                                                                  \
+        static constexpr auto Type = EEventType::name;                                                                 \
+    }
+
+RED4EXT_DECLARE_EVENT(GameStateAdded);
+RED4EXT_DECLARE_EVENT(ScriptsInitialized);
+RED4EXT_DECLARE_EVENT(ScriptsLoaded);
+RED4EXT_DECLARE_EVENT(ProcessExecuting);
+RED4EXT_DECLARE_EVENT(ScriptsValidated);
+RED4EXT_DECLARE_EVENT(SaveableSystemsCollected);
+RED4EXT_DECLARE_EVENT(SessionError);
+
+#undef RED4EXT_DECLARE_EVENT
+} // namespace Events
+
+class EventSystem : public ISystem
+{
+public:
+    using Listener_t = void(RED4EXT_CALL*)(void* aUserData, const void* aEvent);
+
+    EventSystem();
+
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+    bool Subscribe(HMODULE aModule, EEventType aType, Listener_t aListener, void* aUserData);
+    bool Unsubscribe(HMODULE aModule, EEventType aType, Listener_t aListener, void* aUserData);
+    void Unsubscribe(HMODULE aModule);
+
+    template<typename T>
+    void Emit(const T& aEvent)
+    {
+        Emit(Events::Traits<T>::Type, &aEvent);
+    }
+
+private:
+    struct Listener
+    {
+        HMODULE module;
+        Listener_t func;
+        void* userData;
+    };
+
+    using Listeners = std::vector<Listener>;
+
+    void Emit(EEventType aType, const void* aEvent);
+    void Replace(EEventType aType, std::unique_ptr<const Listeners> aListeners);
+
+    static constexpr auto EventCount = static_cast<size_t>(EEventType::Count);
+
+    // Emitting walks the current array without locking or allocating. Changes publish a new array, the old ones are
+    // kept until the system is destroyed since an emit might still be walking them.
+    std::array<std::atomic<const Listeners*>, EventCount> m_listeners;
+
+    ProfiledMutex m_mutex{"event"};
+    std::vector<std::unique_ptr<const Listeners>> m_arrays;
+};
@@ -1,5 +1,6 @@
 #include "stdafx.hpp"
 #include "HookingSystem.hpp"
+#include "App.hpp"
 #include "DetourTransaction.hpp"
 
 #ifdef RED4EXT_PLATFORM_MACOS
@@ -13,11 +14,13 @@ ESystemType HookingSystem::GetType()
 
 void HookingSystem::Startup()
 {
+    auto metricsSystem = App::Get()->GetMetricsSystem();
+    metricsSystem->Publish("hooking.pause_us", DetourTransaction::GetPauseMetric());
 }
 
 void HookingSystem::Shutdown()
 {
-    std::scoped_lock _(m_mutex);
+    auto _ = m_mutex.Lock();
 
     Log::trace("Detaching {} dangling hook(s)...", m_hooks.size());
 
@@ -51,7 +54,7 @@ bool HookingSystem::Attach(std::shared_ptr<PluginBase> aPlugin, const char* aSym
 {
 #ifdef RED4EXT_PLATFORM_MACOS
     Log::trace("Attaching a hook for '{}' at symbol '{}' with detour at {}...", aPlugin->GetName(), aSymbol, aDetour);
-    std::scoped_lock _(m_mutex);
+    auto _ = m_mutex.Lock();
 
     struct rebinding rebind;
     rebind.name = aSymbol;
@@ -81,8 +84,8 @@ bool HookingSystem::Attach(std::shared_ptr<PluginBase> aPlugin, const char* aSym
 
 bool HookingSystem::Attach(std::shared_ptr<PluginBase> aPlugin, void* aTarget, void* aDetour, void** aOriginal)
 {
-    Log::trace(L"Attaching a hook for '{}' at {} with detour at {}...", aPlugin->GetName(), aTarget, aDetour);
-    std::scoped_lock _(m_mutex);
+    Log::trace("Attaching a hook for '{}' at {} with detour at {}...", aPlugin->GetName(), aTarget, aDetour);
+    auto _ = m_mutex.Lock();
 
     DetourTransaction transaction;
     Item item(aTarget, aDetour, aOriginal);
@@ -90,7 +93,7 @@ bool HookingSystem::Attach(std::shared_ptr<PluginBase> aPlugin, void* aTarget, v
     auto result = item.hook.Attach();
     if (result != NO_ERROR)
     {
-        Log::warn(L"The hook requested by '{}' at {} could not be attached. Detour error code: {}",
+        Log::warn("The hook requested by '{}' at {} could not be attached. Detour error code: {}",
                      aPlugin->GetName(), aTarget, result);
         return false;
     }
@@ -104,18 +107,18 @@ bool HookingSystem::Attach(std::shared_ptr<PluginBase> aPlugin, void* aTarget, v
 
         m_hooks.emplace(aPlugin, std::move(item));
 
-        Log::trace(L"The hook requested by '{}' at {} has been successfully attached", aPlugin->GetName(), aTarget);
+        Log::trace("The hook requested by '{}' at {} has been successfully attached", aPlugin->GetName(), aTarget);
         return true;
     }
 
-    Log::warn(L"The hook requested by '{}' at {} was not attached", aPlugin->GetName(), aTarget);
+    Log::warn("The hook requested by '{}' at {} was not attached", aPlugin->GetName(), aTarget);
     return false;
 }
 
 bool HookingSystem::Detach(std::shared_ptr<PluginBase> aPlugin, void* aTarget)
 {
-    Log::trace(L"Detaching all hooks attached by '{}' at {}...", aPlugin->GetName(), aTarget);
-    std::scoped_lock _(m_mutex);
+    Log::trace("Detaching all hooks attached by '{}' at {}...", aPlugin->GetName(), aTarget);
+    auto _ = m_mutex.Lock();
 
     DetourTransaction transaction;
     size_t count = 0;
@@ -138,15 +141,15 @@ bool HookingSystem::Detach(std::shared_ptr<PluginBase> aPlugin, void* aTarget)
 
     if (!hasHook)
     {
-        Log::warn(L"No hooks attached by '{}' at {} were found", aPlugin->GetName(), aTarget);
+        Log::warn("No hooks attached by '{}' at {} were found", aPlugin->GetName(), aTarget);
     }
     else if (count == 0)
     {
-        Log::warn(L"No hooks attached by '{}' at {} were queued for detaching", aPlugin->GetName(), aTarget);
+        Log::warn("No hooks attached by '{}' at {} were queued for detaching", aPlugin->GetName(), aTarget);
     }
     else if (transaction.Commit())
     {
-        Log::trace(L"{} hook(s) attached by '{}' at {} have been successfully detached", count, aPlugin->GetName(),
+        Log::trace("{} hook(s) attached by '{}' at {} have been successfully detached", count, aPlugin->GetName(),
                       aTarget);
 
         for (auto it = range.first; it != range.second;)
@@ -170,6 +173,21 @@ bool HookingSystem::Detach(std::shared_ptr<PluginBase> aPlugin, void* aTarget)
     return count > 0;
 }
 
+std::vector<HookingSystem::HookInfo> HookingSystem::GetHooks()
+{
+    auto _ = m_mutex.Lock();
+
+    std::vector<HookInfo> hooks;
+    hooks.reserve(m_hooks.size());
+
+    for (const auto& [plugin, item] : m_hooks)
+    {
+        hooks.push_back({plugin, item.target, item.symbol});
+    }
+
+    return hooks;
+}
+
 bool HookingSystem::QueueForDetach(std::shared_ptr<PluginBase> aPlugin, Item& aItem)
 {
     if (aItem.symbol)
@@ -197,17 +215,17 @@ bool HookingSystem::QueueForDetach(std::shared_ptr<PluginBase> aPlugin, Item& aI
 
     auto target = aItem.target;
 
-    Log::trace(L"Queueing a hook attached by '{}' at {} for detaching...", aPlugin->GetName(), target);
+    Log::trace("Queueing a hook attached by '{}' at {} for detaching...", aPlugin->GetName(), target);
 
     auto result = aItem.hook.Detach();
     if (result != NO_ERROR)
     {
-        Log::warn(L"A hook attached by '{}' at {} could not be detached. Detour error code: {}", aPlugin->GetName(),
+        Log::warn("A hook attached by '{}' at {} could not be detached. Detour error code: {}", aPlugin->GetName(),
                      target, result);
         return false;
     }
 
-    Log::trace(L"A hook attached by '{}' at {} has been successfully queued for detaching", aPlugin->GetName(),
+    Log::trace("A hook attached by '{}' at {} has been successfully queued for detaching", aPlugin->GetName(),
                   target);
     return true;
 }
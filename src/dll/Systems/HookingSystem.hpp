@@ -3,10 +3,20 @@
 #include "Hook.hpp"
 #include "ISystem.hpp"
 #include "PluginBase.hpp"
+#include "ProfiledMutex.hpp"
 
 class HookingSystem : public ISystem
 {
 public:
+    struct HookInfo
+    {
+        std::shared_ptr<PluginBase> plugin;
+        void* target;
+
+        // Set instead of the target for the hooks attached by symbol.
+        const char* symbol;
+    };
+
     ESystemType GetType() final;
 
     void Startup() final;
@@ -16,6 +26,8 @@ public:
     bool Attach(std::shared_ptr<PluginBase> aPlugin, const char* aSymbol, void* aDetour, void** aOriginal);
     bool Detach(std::shared_ptr<PluginBase> aPlugin, void* aTarget);
 
+    std::vector<HookInfo> GetHooks();
+
 private:
     struct Item
     {
@@ -46,6 +58,6 @@ private:
 
     bool QueueForDetach(std::shared_ptr<PluginBase> aPlugin, Item& aItem);
 
-    std::mutex m_mutex;
+    ProfiledMutex m_mutex{"hooking"};
     Map_t m_hooks;
 };
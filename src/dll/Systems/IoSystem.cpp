@@ -0,0 +1,387 @@
+#include "stdafx.hpp"
+#include "IoSystem.hpp"
+#include "App.hpp"
+#include "Threading.hpp"
+#include "Utils.hpp"
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <dispatch/dispatch.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+constexpr off_t ReadAheadThreshold = 8 * 1024 * 1024;
+#else
+constexpr size_t WorkerCount = 2;
+#endif
+} // namespace
+
+IoSystem::IoSystem(const Paths& aPaths)
+    : m_paths(aPaths)
+{
+}
+
+ESystemType IoSystem::GetType()
+{
+    return ESystemType::Io;
+}
+
+void IoSystem::Startup()
+{
+#ifndef RED4EXT_PLATFORM_MACOS
+    for (size_t i = 0; i < WorkerCount; i++)
+    {
+        auto name = fmt::format("RED4ext IO {}", i);
+        m_workers.push_back(
+            Threading::Start(std::move(name), Threading::Priority::Utility, &IoSystem::RunWorker, this));
+    }
+#endif
+}
+
+void IoSystem::Shutdown()
+{
+    std::vector<std::shared_ptr<Token>> tokens;
+    {
+        auto _ = m_mutex.Lock();
+
+        for (auto& [module, token] : m_tokens)
+        {
+            tokens.push_back(std::move(token));
+        }
+
+        m_tokens.clear();
+        m_completions.clear();
+    }
+
+    for (auto& token : tokens)
+    {
+        std::unique_lock lock(token->mutex);
+        token->isCancelled = true;
+    }
+
+    {
+        auto lock = m_mutex.Lock();
+        if (m_inFlight > 0)
+        {
+            Log::trace("Waiting for {} pending read(s)...", m_inFlight);
+            m_inFlightCondition.wait(lock, [this]() { return m_inFlight == 0; });
+        }
+    }
+
+#ifndef RED4EXT_PLATFORM_MACOS
+    {
+        auto _ = m_queueMutex.Lock();
+        m_isStopping = true;
+    }
+
+    m_queueCondition.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    m_workers.clear();
+#endif
+}
+
+void IoSystem::Submit(HMODULE aModule, std::vector<Request> aRequests, Target aTarget)
+{
+    if (aRequests.empty())
+    {
+        return;
+    }
+
+    std::vector<OperationPtr> operations;
+    operations.reserve(aRequests.size());
+
+    {
+        auto _ = m_mutex.Lock();
+
+        auto& token = m_tokens[aModule];
+        if (!token)
+        {
+            token = std::make_shared<Token>();
+        }
+
+        for (auto& request : aRequests)
+        {
+            auto path = request.path.is_relative() ? m_paths.GetRootDir() / request.path : std::move(request.path);
+            operations.push_back(
+                std::make_shared<Operation>(Operation{std::move(path), std::move(request.callback), aTarget, token}));
+        }
+
+        m_inFlight += operations.size();
+    }
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    for (auto& operation : operations)
+    {
+        Read(std::move(operation));
+    }
+#else
+    {
+        auto _ = m_queueMutex.Lock();
+        m_queue.insert(m_queue.end(), std::make_move_iterator(operations.begin()),
+                       std::make_move_iterator(operations.end()));
+    }
+
+    m_queueCondition.notify_all();
+#endif
+}
+
+void IoSystem::Cancel(HMODULE aModule)
+{
+    std::shared_ptr<Token> token;
+    {
+        auto _ = m_mutex.Lock();
+
+        auto it = m_tokens.find(aModule);
+        if (it == m_tokens.end())
+        {
+            return;
+        }
+
+        token = std::move(it->second);
+        m_tokens.erase(it);
+    }
+
+    std::unique_lock lock(token->mutex);
+    token->isCancelled = true;
+}
+
+void IoSystem::DispatchCompletions()
+{
+    std::vector<std::function<void()>> completions;
+    {
+        auto _ = m_mutex.Lock();
+        if (m_completions.empty())
+        {
+            return;
+        }
+
+        completions.swap(m_completions);
+    }
+
+    for (const auto& completion : completions)
+    {
+        completion();
+    }
+}
+
+void IoSystem::Read(OperationPtr aOperation)
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    auto fd = open(aOperation->path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        Complete(std::move(aOperation), std::error_code(errno, std::generic_category()), nullptr, 0, nullptr);
+        return;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size >= ReadAheadThreshold)
+    {
+        // Ask the kernel to prefetch the whole file instead of growing the read-ahead window as the stream advances.
+        radvisory advisory{};
+        advisory.ra_offset = 0;
+        advisory.ra_count = static_cast<int>(std::min<off_t>(info.st_size, std::numeric_limits<int>::max()));
+
+        fcntl(fd, F_RDAHEAD, 1);
+        fcntl(fd, F_RDADVISE, &advisory);
+    }
+
+    auto queue = dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+    auto channel = dispatch_io_create(DISPATCH_IO_STREAM, fd, queue, ^(int) {
+      close(fd);
+    });
+
+    if (!channel)
+    {
+        close(fd);
+        Complete(std::move(aOperation), std::make_error_code(std::errc::io_error), nullptr, 0, nullptr);
+        return;
+    }
+
+    __block dispatch_data_t buffer = nullptr;
+    dispatch_io_read(channel, 0, SIZE_MAX, queue, ^(bool aDone, dispatch_data_t aData, int aError) {
+      if (aData && dispatch_data_get_size(aData) > 0)
+      {
+          if (buffer)
+          {
+              auto combined = dispatch_data_create_concat(buffer, aData);
+              dispatch_release(buffer);
+
+              buffer = combined;
+          }
+          else
+          {
+              dispatch_retain(aData);
+              buffer = aData;
+          }
+      }
+
+      if (!aDone)
+      {
+          return;
+      }
+
+      const void* data = nullptr;
+      size_t size = 0;
+      std::shared_ptr<const void> storage;
+
+      if (buffer)
+      {
+          auto map = dispatch_data_create_map(buffer, &data, &size);
+          dispatch_release(buffer);
+
+          storage = std::shared_ptr<const void>(map, [](dispatch_data_t aMap) { dispatch_release(aMap); });
+      }
+
+      std::error_code error;
+      if (aError != 0)
+      {
+          error = std::error_code(aError, std::generic_category());
+      }
+
+      Complete(aOperation, error, data, size, std::move(storage));
+      dispatch_release(channel);
+    });
+#else
+    std::error_code error;
+    auto size = std::filesystem::file_size(aOperation->path, error);
+    if (error)
+    {
+        Complete(std::move(aOperation), error, nullptr, 0, nullptr);
+        return;
+    }
+
+    auto buffer = std::make_shared<std::vector<char>>(static_cast<size_t>(size));
+
+    std::ifstream file(aOperation->path, std::ios::binary);
+    if (!file.read(buffer->data(), static_cast<std::streamsize>(buffer->size())))
+    {
+        error = std::make_error_code(std::errc::io_error);
+    }
+
+    Complete(std::move(aOperation), error, buffer->data(), buffer->size(), buffer);
+#endif
+}
+
+void IoSystem::Complete(OperationPtr aOperation, std::error_code aError, const void* aData, size_t aSize,
+                        std::shared_ptr<const void> aStorage)
+{
+    if (aError)
+    {
+        Log::debug("Could not read '{}', error: {}", aOperation->path, aError.message());
+    }
+
+    if (aOperation->target == Target::Worker)
+    {
+        Invoke(*aOperation, aError, aData, aSize);
+    }
+
+    {
+        auto _ = m_mutex.Lock();
+
+        if (aOperation->target == Target::GameThread)
+        {
+            m_completions.emplace_back([this, aOperation, aError, aData, aSize, aStorage]()
+                                       { Invoke(*aOperation, aError, aData, aSize); });
+        }
+
+        m_inFlight--;
+    }
+
+    m_inFlightCondition.notify_all();
+}
+
+void IoSystem::Invoke(const Operation& aOperation, std::error_code aError, const void* aData, size_t aSize)
+{
+    std::shared_lock lock(aOperation.token->mutex);
+    if (aOperation.token->isCancelled)
+    {
+        return;
+    }
+
+    try
+    {
+        aOperation.callback({aOperation.path, aError, aData, aSize});
+    }
+    catch (const std::exception& e)
+    {
+        Log::warn("An exception occured while completing the read of '{}'", aOperation.path);
+        Log::warn(e.what());
+    }
+    catch (...)
+    {
+        Log::warn("An unknown exception occured while completing the read of '{}'", aOperation.path);
+    }
+}
+
+#ifndef RED4EXT_PLATFORM_MACOS
+void IoSystem::RunWorker()
+{
+    while (true)
+    {
+        OperationPtr operation;
+        {
+            auto lock = m_queueMutex.Lock();
+            m_queueCondition.wait(lock, [this]() { return m_isStopping || !m_queue.empty(); });
+
+            if (m_queue.empty())
+            {
+                return;
+            }
+
+            operation = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        Read(std::move(operation));
+    }
+}
+#endif
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_ReadFilesAsync(RED4ext::PluginHandle aHandle,
+                                                          const RED4ext_ReadRequest* aRequests, size_t aCount,
+                                                          bool aOnGameThread)
+{
+    auto app = App::Get();
+    if (!app || !aRequests)
+    {
+        return false;
+    }
+
+    auto pluginSystem = app->GetPluginSystem();
+    if (!pluginSystem->GetPlugin(aHandle))
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return false;
+    }
+
+    std::vector<IoSystem::Request> requests;
+    requests.reserve(aCount);
+
+    for (size_t i = 0; i < aCount; i++)
+    {
+        const auto& request = aRequests[i];
+        if (!request.path || !request.callback)
+        {
+            Log::warn("One of the required parameters for read request #{} is NULL", i);
+            return false;
+        }
+
+        requests.push_back({request.path, [callback = request.callback, userData = request.userData](
+                                              const IoSystem::Result& aResult)
+                            { callback(userData, aResult.error.value(), aResult.data, aResult.size); }});
+    }
+
+    auto target = aOnGameThread ? IoSystem::Target::GameThread : IoSystem::Target::Worker;
+    app->GetIoSystem()->Submit(aHandle, std::move(requests), target);
+
+    return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "ISystem.hpp"
+#include "Paths.hpp"
+#include "ProfiledMutex.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <shared_mutex>
+
+/*
+ * Plugin-facing ABI of 'RED4ext_ReadFilesAsync'. The data passed to the callback is only valid for the duration of the
+ * call, 'aError' is zero on success or an errno value otherwise.
+ */
+using RED4ext_ReadCallback_t = void(RED4EXT_CALL*)(void* aUserData, int32_t aError, const void* aData, size_t aSize);
+
+struct RED4ext_ReadRequest
+{
+    const wchar_t* path;
+    RED4ext_ReadCallback_t callback;
+    void* userData;
+};
+
+class IoSystem : public ISystem
+{
+public:
+    enum class Target : uint8_t
+    {
+        GameThread,
+        Worker
+    };
+
+    struct Result
+    {
+        const std::filesystem::path& path;
+        std::error_code error;
+
+        const void* data;
+        size_t size;
+    };
+
+    using Callback_t = std::function<void(const Result&)>;
+
+    struct Request
+    {
+        std::filesystem::path path;
+        Callback_t callback;
+    };
+
+    IoSystem(const Paths& aPaths);
+
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+    // Relative paths are resolved against the game's root directory.
+    void Submit(HMODULE aModule, std::vector<Request> aRequests, Target aTarget);
+
+    // Drops the pending completions of the module and waits for the callbacks that are already running.
+    void Cancel(HMODULE aModule);
+
+    // Runs the completions routed to the game thread, called once per frame.
+    void DispatchCompletions();
+
+private:
+    struct Token
+    {
+        std::shared_mutex mutex;
+        bool isCancelled = false;
+    };
+
+    struct Operation
+    {
+        std::filesystem::path path;
+        Callback_t callback;
+        Target target;
+        std::shared_ptr<Token> token;
+    };
+
+    using OperationPtr = std::shared_ptr<Operation>;
+
+    void Read(OperationPtr aOperation);
+    void Complete(OperationPtr aOperation, std::error_code aError, const void* aData, size_t aSize,
+                  std::shared_ptr<const void> aStorage);
+    void Invoke(const Operation& aOperation, std::error_code aError, const void* aData, size_t aSize);
+
+#ifndef RED4EXT_PLATFORM_MACOS
+    void RunWorker();
+
+    std::vector<std::thread> m_workers;
+    ProfiledMutex m_queueMutex{"io.queue"};
+    std::condition_variable_any m_queueCondition;
+    std::list<OperationPtr> m_queue;
+    bool m_isStopping = false;
+#endif
+
+    const Paths& m_paths;
+
+    ProfiledMutex m_mutex{"io"};
+    std::unordered_map<HMODULE, std::shared_ptr<Token>> m_tokens;
+    std::vector<std::function<void()>> m_completions;
+
+    size_t m_inFlight = 0;
+    std::condition_variable_any m_inFlightCondition;
+};
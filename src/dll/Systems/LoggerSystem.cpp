@@ -1,4 +1,5 @@
 #include "LoggerSystem.hpp"
+#include "App.hpp"
 #include "Config.hpp"
 #include "Paths.hpp"
 #include "stdafx.hpp"
@@ -17,10 +18,15 @@ ESystemType LoggerSystem::GetType()
 
 void LoggerSystem::Startup()
 {
+    // A reload of the config file sets every logger to its level, put the overrides back on top of it.
+    auto configSystem = App::Get()->GetConfigSystem();
+    m_configSubscription = configSystem->Subscribe(nullptr, [this](const ConfigSystem::Snapshot&) { ApplyLevels(); });
 }
 
 void LoggerSystem::Shutdown()
 {
+    App::Get()->GetConfigSystem()->Unsubscribe(m_configSubscription);
+
     auto count = m_loggers.size();
 
     Log::trace("Flusing {} logger(s)...", count);
@@ -34,7 +40,63 @@ void LoggerSystem::Shutdown()
     Log::trace("{} logger(s) flushed", count);
 }
 
-void LoggerSystem::RotateLogs(std::vector<std::wstring> pluginNames) const
+void LoggerSystem::ApplyLiveConfig(spdlog::logger& aLogger) const
+{
+    // The config file might have been reloaded since startup, the logger was created with the startup levels.
+    auto configSystem = App::Get()->GetConfigSystem();
+    configSystem->ApplyLogging(aLogger);
+
+    auto it = m_levels.find(aLogger.name());
+    if (it != m_levels.end())
+    {
+        aLogger.set_level(it->second);
+    }
+}
+
+void LoggerSystem::SetLevel(std::string_view aName, std::optional<spdlog::level::level_enum> aLevel)
+{
+    {
+        auto _ = m_loggersMutex.Lock();
+
+        if (aLevel)
+        {
+            m_levels.insert_or_assign(std::string(aName), *aLevel);
+        }
+        else
+        {
+            m_levels.erase(std::string(aName));
+        }
+    }
+
+    ApplyLevels();
+}
+
+void LoggerSystem::BeginTrace()
+{
+    spdlog::apply_all(
+        [](std::shared_ptr<spdlog::logger> aLogger)
+        {
+            aLogger->set_level(spdlog::level::trace);
+            aLogger->flush_on(spdlog::level::trace);
+        });
+}
+
+void LoggerSystem::ApplyLevels()
+{
+    auto _ = m_loggersMutex.Lock();
+
+    if (auto logger = spdlog::default_logger())
+    {
+        ApplyLiveConfig(*logger);
+    }
+
+    for (auto& [plugin, logger] : m_loggers)
+    {
+        ApplyLiveConfig(*logger);
+    }
+}
+
+void LoggerSystem::RotateLogs(std::vector<std::string> pluginNames) const
 {
     std::error_code error;
     auto files = std::filesystem::directory_iterator(m_paths.GetLogsDir(), error);
@@ -45,16 +107,14 @@ void LoggerSystem::RotateLogs(std::vector<std::wstring> pluginNames) const
         return;
     }
     Log::trace("Rotate logs...");
-    pluginNames.emplace_back(L"RED4ext");
+    pluginNames.emplace_back("RED4ext");
 
     // List all log files.
     std::vector<std::filesystem::path> logs;
 
     for (const std::filesystem::directory_entry& file : files)
     {
-        const auto fileName = file.path().filename().wstring();
-
-        if (file.is_regular_file() && fileName.ends_with(L".log"))
+        if (file.is_regular_file() && file.path().extension() == ".log")
         {
             logs.emplace_back(file.path());
         }
@@ -62,15 +122,15 @@ void LoggerSystem::RotateLogs(std::vector<std::wstring> pluginNames) const
     const Config::LoggingConfig config = m_config.GetLogging();
 
     // Rotate oldest logs per plugin.
-    for (auto pluginName : pluginNames)
+    for (const auto& name : pluginNames)
     {
-        pluginName = Utils::ToLower(pluginName);
+        const auto pluginName = Utils::ToLower(name);
         std::vector<std::filesystem::path> pluginLogs;
 
         logs.erase(std::remove_if(logs.begin(), logs.end(),
                                   [&pluginName, &pluginLogs](const auto& log)
                                   {
-                                      if (log.filename().wstring().starts_with(pluginName))
+                                      if (Utils::ToString(log.filename()).starts_with(pluginName))
                                       {
                                           pluginLogs.push_back(log);
                                           return true;
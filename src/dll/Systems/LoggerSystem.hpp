@@ -1,9 +1,10 @@
 #pragma once
 
-#include <cwctype>
+#include <optional>
 
 #include "ISystem.hpp"
 #include "PluginBase.hpp"
+#include "ProfiledMutex.hpp"
 #include "Utils.hpp"
 
 class LoggerSystem : public ISystem
@@ -16,7 +17,17 @@ public:
     void Startup() final;
     void Shutdown() final;
 
-    void RotateLogs(std::vector<std::wstring> plugins) const;
+    void RotateLogs(std::vector<std::string> plugins) const;
+
+    // Overrides the level of a logger ('RED4ext' or a plugin's name) until the game exits, 'std::nullopt' goes back to
+    // the level of the config file. The override also applies to a plugin logger that is created later.
+    void SetLevel(std::string_view aName, std::optional<spdlog::level::level_enum> aLevel);
+
+    // Logs and flushes every message of every logger until 'ApplyLevels' is called.
+    void BeginTrace();
+
+    // Applies the levels of the config file and the overrides to every logger.
+    void ApplyLevels();
 
     void Trace(std::shared_ptr<PluginBase> aPlugin, std::string_view aText);
     void Trace(std::shared_ptr<PluginBase> aPlugin, std::wstring_view aText);
@@ -37,6 +48,8 @@ public:
     void Critical(std::shared_ptr<PluginBase> aPlugin, std::wstring_view aText);
 
 private:
+    void ApplyLiveConfig(spdlog::logger& aLogger) const;
+
     template<typename T>
     inline void Log(std::shared_ptr<PluginBase> aPlugin, spdlog::level::level_enum aLevel,
                     std::basic_string_view<T> aText)
@@ -49,7 +62,7 @@ private:
         std::shared_ptr<spdlog::logger> logger;
 
         {
-            std::scoped_lock _(m_loggersMutex);
+            auto _ = m_loggersMutex.Lock();
 
             auto it = m_loggers.find(aPlugin);
             if (it != m_loggers.end())
@@ -59,15 +72,11 @@ private:
             else
             {
                 const auto& path = aPlugin->GetPath();
-                const auto stem = path.stem();
-                auto fileName = stem.wstring();
-
-                fileName = Utils::ToLower(fileName);
-
-                const auto logName = aPlugin->GetName();
+                const auto stem = Utils::ToLower(Utils::ToString(path.stem()));
 
-                fileName = fmt::format(L"{}-{}.log", fileName, Utils::FormatCurrentTimestamp());
-                logger = Utils::CreateLogger(logName, fileName, m_paths, m_config, m_devConsole);
+                const auto fileName = fmt::format("{}-{}.log", stem, Utils::FormatCurrentTimestamp());
+                logger = Utils::CreateLogger(aPlugin->GetName(), fileName, m_paths, m_config, m_devConsole);
+                ApplyLiveConfig(*logger);
                 m_loggers.emplace(aPlugin, logger);
             }
         }
@@ -90,6 +99,8 @@ private:
     const Config& m_config;
     const DevConsole& m_devConsole;
 
-    std::mutex m_loggersMutex;
+    ProfiledMutex m_loggersMutex{"logger"};
     std::unordered_map<std::shared_ptr<PluginBase>, std::shared_ptr<spdlog::logger>> m_loggers;
+    std::unordered_map<std::string, spdlog::level::level_enum> m_levels;
+    uint64_t m_configSubscription = 0;
 };
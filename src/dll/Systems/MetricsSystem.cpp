@@ -0,0 +1,193 @@
+#include "stdafx.hpp"
+#include "MetricsSystem.hpp"
+#include "Platform/FridaHookCounters.hpp"
+
+#include <algorithm>
+
+MetricsSystem::MetricsSystem()
+    : m_startTime(std::chrono::steady_clock::now())
+{
+}
+
+ESystemType MetricsSystem::GetType()
+{
+    return ESystemType::Metrics;
+}
+
+void MetricsSystem::Startup()
+{
+}
+
+void MetricsSystem::Shutdown()
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    const auto fridaCounters = FridaHookCounters::Collect();
+    if (!fridaCounters.empty())
+    {
+        std::vector<std::string> calls;
+        for (const auto& counter : fridaCounters)
+        {
+            calls.push_back(fmt::format("{}={}", counter.name, counter.calls));
+        }
+
+        Log::info("Calls of the Frida hooks: {}", fmt::join(calls, ", "));
+    }
+#endif
+
+    auto samples = Collect();
+    if (samples.empty())
+    {
+        return;
+    }
+
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(GetUptime()).count();
+    Log::debug("Metrics after {} second(s):", uptime);
+
+    for (const auto& sample : samples)
+    {
+        Log::debug("  {}: {} (peak: {})", sample.name, sample.value, sample.peak);
+    }
+
+    for (const auto& lock : ProfiledMutex::Collect())
+    {
+        if (lock.sites.empty())
+        {
+            continue;
+        }
+
+        Log::debug("Call sites that waited the longest for the '{}' lock:", lock.name);
+        for (const auto& site : lock.sites)
+        {
+            Log::debug("  {}: {} contention(s), {} us", site.location, site.contentions,
+                       std::chrono::duration_cast<std::chrono::microseconds>(site.wait).count());
+        }
+    }
+}
+
+MetricsSystem::Metric* MetricsSystem::Register(std::string_view aName)
+{
+    auto _ = m_mutex.Lock();
+
+    auto it = m_owned.find(aName);
+    if (it != m_owned.end())
+    {
+        return it->second.get();
+    }
+
+    auto metric = std::make_unique<Metric>();
+    auto ptr = metric.get();
+
+    m_owned.emplace(aName, std::move(metric));
+    m_metrics.insert_or_assign(std::string(aName), ptr);
+
+    return ptr;
+}
+
+void MetricsSystem::Publish(std::string_view aName, const Metric& aMetric)
+{
+    auto _ = m_mutex.Lock();
+    m_metrics.insert_or_assign(std::string(aName), &aMetric);
+}
+
+void MetricsSystem::Unpublish(const Metric& aMetric)
+{
+    auto _ = m_mutex.Lock();
+    std::erase_if(m_metrics, [&aMetric](const auto& aItem) { return aItem.second == &aMetric; });
+}
+
+std::vector<MetricsSystem::Sample> MetricsSystem::Collect() const
+{
+    std::vector<Sample> samples;
+
+    {
+        auto _ = m_mutex.Lock();
+
+        samples.reserve(m_metrics.size());
+        for (const auto& [name, metric] : m_metrics)
+        {
+            samples.push_back({name, metric->GetValue(), metric->GetPeak()});
+        }
+    }
+
+    for (const auto& lock : ProfiledMutex::Collect())
+    {
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+
+        const auto acquisitions = static_cast<int64_t>(lock.acquisitions);
+        const auto contentions = static_cast<int64_t>(lock.contentions);
+        const auto wait = duration_cast<microseconds>(lock.wait).count();
+        const auto maxWait = duration_cast<microseconds>(lock.maxWait).count();
+        const auto hold = lock.hold.count();
+
+        samples.push_back({fmt::format("locks.{}.acquisitions", lock.name), acquisitions, acquisitions});
+        samples.push_back({fmt::format("locks.{}.contentions", lock.name), contentions, contentions});
+        samples.push_back({fmt::format("locks.{}.wait_us", lock.name), wait, maxWait});
+        samples.push_back({fmt::format("locks.{}.hold_ns", lock.name), hold, hold});
+    }
+
+#ifdef RED4EXT_PLATFORM_MACOS
+    for (const auto& counter : FridaHookCounters::Collect())
+    {
+        const auto calls = static_cast<int64_t>(counter.calls);
+        samples.push_back({fmt::format("hooks.frida.{}.calls", counter.name), calls, calls});
+    }
+#endif
+
+    std::ranges::sort(samples, std::ranges::less{}, &Sample::name);
+    return samples;
+}
+
+std::chrono::steady_clock::duration MetricsSystem::GetUptime() const
+{
+    return std::chrono::steady_clock::now() - m_startTime;
+}
+
+void MetricsSystem::Metric::Add(int64_t aDelta)
+{
+    auto value = m_value.fetch_add(aDelta, std::memory_order_relaxed) + aDelta;
+    UpdatePeak(value);
+}
+
+void MetricsSystem::Metric::Add(int64_t aDelta, int64_t aMinimum)
+{
+    auto value = m_value.load(std::memory_order_relaxed);
+
+    int64_t next;
+    do
+    {
+        next = std::max(value + aDelta, aMinimum);
+    } while (!m_value.compare_exchange_weak(value, next, std::memory_order_relaxed));
+
+    UpdatePeak(next);
+}
+
+void MetricsSystem::Metric::Set(int64_t aValue)
+{
+    m_value.store(aValue, std::memory_order_relaxed);
+    UpdatePeak(aValue);
+}
+
+void MetricsSystem::Metric::Reset()
+{
+    m_value.store(0, std::memory_order_relaxed);
+    m_peak.store(0, std::memory_order_relaxed);
+}
+
+int64_t MetricsSystem::Metric::GetValue() const
+{
+    return m_value.load(std::memory_order_relaxed);
+}
+
+int64_t MetricsSystem::Metric::GetPeak() const
+{
+    return m_peak.load(std::memory_order_relaxed);
+}
+
+void MetricsSystem::Metric::UpdatePeak(int64_t aValue)
+{
+    auto peak = m_peak.load(std::memory_order_relaxed);
+    while (aValue > peak && !m_peak.compare_exchange_weak(peak, aValue, std::memory_order_relaxed))
+    {
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ISystem.hpp"
+#include "ProfiledMutex.hpp"
+
+class MetricsSystem : public ISystem
+{
+public:
+    class Metric
+    {
+    public:
+        void Add(int64_t aDelta);
+        void Set(int64_t aValue);
+
+        // Adds the delta without going below the minimum.
+        void Add(int64_t aDelta, int64_t aMinimum);
+
+        // Sets the value and the peak back to zero.
+        void Reset();
+
+        int64_t GetValue() const;
+        int64_t GetPeak() const;
+
+    private:
+        void UpdatePeak(int64_t aValue);
+
+        std::atomic<int64_t> m_value{0};
+        std::atomic<int64_t> m_peak{0};
+    };
+
+    struct Sample
+    {
+        std::string name;
+        int64_t value;
+        int64_t peak;
+    };
+
+    MetricsSystem();
+
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+    // Returns a metric owned by the system, the pointer stays valid until the system is destroyed.
+    Metric* Register(std::string_view aName);
+
+    // Publishes a metric owned by the caller, the metric must outlive the system.
+    void Publish(std::string_view aName, const Metric& aMetric);
+
+    // Removes every name the metric was published under.
+    void Unpublish(const Metric& aMetric);
+
+    std::vector<Sample> Collect() const;
+    std::chrono::steady_clock::duration GetUptime() const;
+
+private:
+    const std::chrono::steady_clock::time_point m_startTime;
+
+    mutable ProfiledMutex m_mutex{"metrics"};
+    std::map<std::string, std::unique_ptr<Metric>, std::less<>> m_owned;
+    std::map<std::string, const Metric*, std::less<>> m_metrics;
+};
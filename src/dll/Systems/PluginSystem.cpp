@@ -1,4 +1,6 @@
 #include "PluginSystem.hpp"
+#include "App.hpp"
+#include "HeapAccounting.hpp"
 #include "Image.hpp"
 #include "Utils.hpp"
 #include "Version.hpp"
@@ -14,13 +16,13 @@
     auto val = ec.value();                                                                                             \
     const auto& category = ec.category();                                                                              \
     auto msg = category.message(val);                                                                                  \
-    Log::error(text L". Error code: {}, msg: '{}'", val, Utils::Widen(msg))
+    Log::error(text ". Error code: {}, msg: '{}'", val, msg)
 
 #define LOG_FS_ENTRY_ERROR(text, entry, ec)                                                                            \
     auto val = ec.value();                                                                                             \
     const auto& category = ec.category();                                                                              \
     auto msg = category.message(val);                                                                                  \
-    Log::error(text L". Error code: {}, msg: '{}', entry: '{}'", val, Utils::Widen(msg), entry)
+    Log::error(text ". Error code: {}, msg: '{}', entry: '{}'", val, msg, entry)
 
 PluginSystem::PluginSystem(const Config::PluginsConfig& aConfig, const Paths& aPaths)
     : m_config(aConfig)
@@ -93,7 +95,7 @@ void PluginSystem::Startup()
 
         if (ec)
         {
-            LOG_FS_ENTRY_ERROR(L"Could not fetch a directory entry", path, ec);
+            LOG_FS_ENTRY_ERROR("Could not fetch a directory entry", path, ec);
             continue;
         }
 
@@ -103,36 +105,31 @@ void PluginSystem::Startup()
             if (!entry.exists(ec))
             {
                 // Symlink is broken, skip it.
-                Log::warn(L"Symbolic link is broken, it will be skipped. Symlink: '{}'", path);
+                Log::warn("Symbolic link is broken, it will be skipped. Symlink: '{}'", path);
                 continue;
             }
             else if (ec)
             {
-                LOG_FS_ENTRY_ERROR(L"Could not check if the symlink exists", path, ec);
+                LOG_FS_ENTRY_ERROR("Could not check if the symlink exists", path, ec);
                 continue;
             }
         }
         else if (ec)
         {
-            LOG_FS_ENTRY_ERROR(L"Could not check if the entry is a symbolic link", path, ec);
+            LOG_FS_ENTRY_ERROR("Could not check if the entry is a symbolic link", path, ec);
             continue;
         }
 
 #ifdef RED4EXT_PLATFORM_MACOS
-        if (entry.is_regular_file(ec) && path.extension() == L".dylib")
+        if (entry.is_regular_file(ec) && path.extension() == ".dylib")
 #else
-        if (entry.is_regular_file(ec) && path.extension() == L".dll")
+        if (entry.is_regular_file(ec) && path.extension() == ".dll")
 #endif
         {
-            const auto stem = path.stem();
-#ifdef RED4EXT_PLATFORM_MACOS
-            // On macOS, convert to wstring for comparison with ignored list
-            if (m_config.ignored.count(stem.wstring()) > 0)
-#else
+            const auto stem = Utils::ToString(path.stem());
             if (m_config.ignored.contains(stem))
-#endif
             {
-                Log::debug(L"Skipping loading '{}', the plugin is ignored by the user. Path: '{}", stem, path);
+                Log::debug("Skipping loading '{}', the plugin is ignored by the user. Path: '{}", stem, path);
                 continue;
             }
 
@@ -142,7 +139,7 @@ void PluginSystem::Startup()
         }
         else if (ec)
         {
-            LOG_FS_ENTRY_ERROR(L"Could not check if the entry is a regular file", path, ec);
+            LOG_FS_ENTRY_ERROR("Could not check if the entry is a regular file", path, ec);
         }
     }
 
@@ -174,6 +171,12 @@ void PluginSystem::Shutdown()
         it = Unload(it->second);
     }
 
+    if (!m_unloadedPlugins.empty())
+    {
+        // The allocator releases the remaining arenas when it shuts down, after the systems still holding the plugins.
+        Log::debug("{} unloaded plugin(s) are still referenced, their pool arena is kept", m_unloadedPlugins.size());
+    }
+
     Log::info("{} plugin(s) unloaded", size);
 }
 
@@ -206,15 +209,30 @@ std::vector<PluginSystem::PluginName> PluginSystem::GetActivePlugins() const
     return plugins;
 }
 
+std::vector<std::shared_ptr<PluginBase>> PluginSystem::GetPlugins() const
+{
+    std::vector<std::shared_ptr<PluginBase>> plugins;
+
+    plugins.reserve(m_plugins.size());
+    for (const auto& [handle, plugin] : m_plugins)
+    {
+        plugins.push_back(plugin);
+    }
+    return plugins;
+}
+
 void PluginSystem::Load(const std::filesystem::path& aPath, bool aUseAlteredSearchPath)
 {
-    Log::info(L"Loading plugin from '{}'...", aPath);
+    Log::info("Loading plugin from '{}'...", aPath);
+
+    // The module about to be opened can get the handle of a closed one, its arena must be gone by then.
+    ReleaseArenas();
 
     const auto stem = aPath.stem();
 
     wil::unique_hmodule handle;
 #ifdef RED4EXT_PLATFORM_MACOS
-    if (aPath.extension() == L".app" || aPath.filename() == L"Cyberpunk2077")
+    if (aPath.extension() == ".app" || aPath.filename() == "Cyberpunk2077")
     {
         // Main executable - use RTLD_DEFAULT
         handle.reset(RTLD_DEFAULT);
@@ -235,8 +253,8 @@ void PluginSystem::Load(const std::filesystem::path& aPath, bool aUseAlteredSear
         if (!h)
         {
             const char* err = dlerror();
-            Log::warn(L"Could not load plugin '{}'. Error: '{}', path: '{}'", stem, 
-                        err ? Utils::Widen(err) : L"Unknown error", aPath);
+            Log::warn("Could not load plugin '{}'. Error: '{}', path: '{}'", stem, 
+                        err ? err : "Unknown error", aPath);
             return;
         }
         handle.reset(h);
@@ -248,7 +266,7 @@ void PluginSystem::Load(const std::filesystem::path& aPath, bool aUseAlteredSear
         flags = LOAD_WITH_ALTERED_SEARCH_PATH;
     }
 
-    if (aPath.extension() == L".exe")
+    if (aPath.extension() == ".exe")
         handle.reset(GetModuleHandleA(nullptr));
     else
         handle.reset(LoadLibraryEx(aPath.c_str(), nullptr, flags));
@@ -256,13 +274,13 @@ void PluginSystem::Load(const std::filesystem::path& aPath, bool aUseAlteredSear
     if (!handle)
     {
         auto msg = Utils::FormatLastError();
-        Log::warn(L"Could not load plugin '{}'. Error code: {}, msg: '{}', path: '{}'", stem, GetLastError(), msg,
-                     aPath);
+        Log::warn("Could not load plugin '{}'. Error code: {}, msg: '{}', path: '{}'", stem, GetLastError(),
+                  Utils::Narrow(msg), aPath);
         return;
     }
 #endif
 
-    Log::trace(L"'{}' has been loaded into the address space at {}", stem, fmt::ptr(handle.get()));
+    Log::trace("'{}' has been loaded into the address space at {}", stem, fmt::ptr(handle.get()));
 
     auto plugin = CreatePlugin(aPath, std::move(handle));
     if (!plugin)
@@ -301,8 +319,8 @@ void PluginSystem::Load(const std::filesystem::path& aPath, bool aUseAlteredSear
         if (!isSupported)
         {
             Log::warn(
-                L"{} (version: {}) is incompatible with the current patch. The requested runtime of the plugin is {}",
-                pluginName, std::to_wstring(pluginVersion), requestedRuntime);
+                "{} (version: {}) is incompatible with the current patch. The requested runtime of the plugin is {}",
+                pluginName, std::to_string(pluginVersion), requestedRuntime);
 
             m_incompatiblePlugins.emplace_back(pluginName);
             return;
@@ -312,26 +330,35 @@ void PluginSystem::Load(const std::filesystem::path& aPath, bool aUseAlteredSear
     const auto& pluginSdk = plugin->GetSdkVersion();
     if (pluginSdk < MINIMUM_SDK_VERSION || pluginSdk > LATEST_SDK_VERSION)
     {
-        Log::warn(L"{} (version: {}) uses RED4ext.SDK v{} which is not supported by RED4ext v{}. If you are the "
-                     L"plugin's author, recompile the plugin with a version of RED4ext.SDK that meets the following "
-                     L"criteria: RED4ext.SDK >= {} && RED4ext.SDK <= {}",
-                     pluginName, std::to_wstring(pluginVersion), std::to_wstring(pluginSdk), TEXT(RED4EXT_VERSION_STR),
-                     std::to_wstring(MINIMUM_SDK_VERSION), std::to_wstring(LATEST_SDK_VERSION));
+        Log::warn("{} (version: {}) uses RED4ext.SDK v{} which is not supported by RED4ext v{}. If you are the "
+                     "plugin's author, recompile the plugin with a version of RED4ext.SDK that meets the following "
+                     "criteria: RED4ext.SDK >= {} && RED4ext.SDK <= {}",
+                     pluginName, std::to_string(pluginVersion), std::to_string(pluginSdk), RED4EXT_VERSION_STR,
+                     std::to_string(MINIMUM_SDK_VERSION), std::to_string(LATEST_SDK_VERSION));
         return;
     }
 
     auto module = plugin->GetModule();
     m_plugins.emplace(module, plugin);
 
+#ifdef RED4EXT_PLATFORM_MACOS
+    // Attached once the plugin is accepted, a rejected image never gets a slot. The executable hosting RED4ext is not
+    // rebound.
+    if (m_config.isHeapAccountingEnabled && module != RTLD_DEFAULT && HeapAccounting::Attach(module, aPath))
+    {
+        HeapAccounting::Publish(module, pluginName);
+    }
+#endif
+
     if (!plugin->Main(RED4ext::EMainReason::Load))
     {
-        Log::warn(L"{} did not initialize properly, unloading...", pluginName);
-        Unload(plugin);
+        Log::warn("{} did not initialize properly, unloading...", pluginName);
+        Unload(std::move(plugin));
 
         return;
     }
 
-    Log::info(L"{} (version: {}, author(s): {}) has been loaded", pluginName, std::to_wstring(pluginVersion),
+    Log::info("{} (version: {}, author(s): {}) has been loaded", pluginName, std::to_string(pluginVersion),
                  plugin->GetAuthor());
 }
 
@@ -340,13 +367,56 @@ PluginSystem::MapIter_t PluginSystem::Unload(std::shared_ptr<PluginBase> aPlugin
     aPlugin->Main(RED4ext::EMainReason::Unload);
 
     auto module = aPlugin->GetModule();
+    if (m_config.isHeapAccountingEnabled)
+    {
+        HeapAccounting::Report(module, aPlugin->GetName());
+    }
+
+    auto app = App::Get();
+
+    auto ioSystem = app->GetIoSystem();
+    ioSystem->Cancel(module);
+
+    auto configSystem = app->GetConfigSystem();
+    configSystem->Unsubscribe(module);
+
+    auto eventSystem = app->GetEventSystem();
+    eventSystem->Unsubscribe(module);
+
+    auto snapshotSystem = app->GetSnapshotSystem();
+    snapshotSystem->Unregister(module);
+
+    PluginName name(aPlugin->GetName());
+
     auto iter = m_plugins.find(module);
     auto result = m_plugins.erase(iter);
 
-    Log::info(L"{} has been unloaded", aPlugin->GetName());
+    // The module is closed with the last reference to the plugin, its static destructors might still free memory from
+    // its arena until then.
+    m_unloadedPlugins.push_back({aPlugin, module, name});
+    aPlugin.reset();
+    ReleaseArenas();
+
+    Log::info("{} has been unloaded", name);
     return result;
 }
 
+void PluginSystem::ReleaseArenas()
+{
+    auto allocatorSystem = App::Get()->GetAllocatorSystem();
+    std::erase_if(m_unloadedPlugins,
+                  [allocatorSystem](const UnloadedPlugin& aPlugin)
+                  {
+                      if (!aPlugin.plugin.expired())
+                      {
+                          return false;
+                      }
+
+                      allocatorSystem->ReleaseArena(aPlugin.module, aPlugin.name);
+                      return true;
+                  });
+}
+
 std::shared_ptr<PluginBase> PluginSystem::CreatePlugin(const std::filesystem::path& aPath,
                                                        wil::unique_hmodule aModule) const
 {
@@ -365,8 +435,8 @@ std::shared_ptr<PluginBase> PluginSystem::CreatePlugin(const std::filesystem::pa
         if (err != ERROR_PROC_NOT_FOUND)
         {
             auto msg = Utils::FormatLastError();
-            Log::warn(L"Could not retrieve 'Supports' function from '{}'. Error code: {}, msg: '{}', path: '{}'",
-                         stem, GetLastError(), msg, aPath);
+            Log::warn("Could not retrieve 'Supports' function from '{}'. Error code: {}, msg: '{}', path: '{}'",
+                         stem, GetLastError(), Utils::Narrow(msg), aPath);
         }
 
         return nullptr;
@@ -381,21 +451,21 @@ std::shared_ptr<PluginBase> PluginSystem::CreatePlugin(const std::filesystem::pa
     }
     catch (const std::exception& e)
     {
-        Log::warn(L"An exception occurred while calling 'Supports' function exported by '{}'. Path: '{}'", stem,
+        Log::warn("An exception occurred while calling 'Supports' function exported by '{}'. Path: '{}'", stem,
                      aPath);
         Log::warn(e.what());
         return nullptr;
     }
     catch (...)
     {
-        Log::warn(L"An unknown exception occurred while calling 'Supports' function exported by '{}'. Path: '{}'",
+        Log::warn("An unknown exception occurred while calling 'Supports' function exported by '{}'. Path: '{}'",
                      stem, aPath);
         return nullptr;
     }
 
     if (apiVersion < MINIMUM_API_VERSION || apiVersion > LATEST_API_VERSION)
     {
-        Log::warn(L"'{}' is using an unsupported API version. API version: {}, path: '{}'", stem, apiVersion, aPath);
+        Log::warn("'{}' is using an unsupported API version. API version: {}, path: '{}'", stem, apiVersion, aPath);
         return nullptr;
     }
 
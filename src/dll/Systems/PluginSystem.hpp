@@ -8,7 +8,7 @@
 class PluginSystem : public ISystem
 {
 public:
-    using PluginName = std::wstring;
+    using PluginName = std::string;
 
     PluginSystem(const Config::PluginsConfig& aConfig, const Paths& aPaths);
     ~PluginSystem() = default;
@@ -21,6 +21,7 @@ public:
     std::shared_ptr<PluginBase> GetPlugin(HMODULE aModule) const;
     const std::vector<PluginName>& GetIncompatiblePlugins() const;
     std::vector<PluginName> GetActivePlugins() const;
+    std::vector<std::shared_ptr<PluginBase>> GetPlugins() const;
 
 private:
     using Map_t = std::unordered_map<HMODULE, std::shared_ptr<PluginBase>>;
@@ -32,14 +33,26 @@ private:
         bool useAlteredSearchPath;
     };
 
+    // An unloaded plugin whose module might still be open because something else holds a reference to it.
+    struct UnloadedPlugin
+    {
+        std::weak_ptr<PluginBase> plugin;
+        HMODULE module;
+        PluginName name;
+    };
+
     void Load(const std::filesystem::path& aPath, bool aUseAlteredSearchPath);
     MapIter_t Unload(std::shared_ptr<PluginBase> aPlugin);
 
+    // Releases the pool arenas of the unloaded plugins whose module was closed.
+    void ReleaseArenas();
+
     std::shared_ptr<PluginBase> CreatePlugin(const std::filesystem::path& aPath, wil::unique_hmodule aModule) const;
 
     const Config::PluginsConfig& m_config;
     const Paths& m_paths;
 
     Map_t m_plugins;
+    std::vector<UnloadedPlugin> m_unloadedPlugins;
     std::vector<PluginName> m_incompatiblePlugins;
 };
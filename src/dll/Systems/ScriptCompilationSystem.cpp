@@ -23,7 +23,7 @@ void ScriptCompilationSystem::Shutdown()
 
 void ScriptCompilationSystem::Add(std::shared_ptr<PluginBase> aPlugin, std::filesystem::path aPath)
 {
-    std::scoped_lock _(m_mutex);
+    auto _ = m_mutex.Lock();
     m_scriptPaths.emplace(aPlugin, std::move(aPath));
 }
 
@@ -131,10 +131,10 @@ std::wstring ScriptCompilationSystem::GetCompilationArgs(const FixedWString& aOr
     std::wofstream pathsFile(pathsFilePath, std::ios::out);
     for (const auto& [plugin, path] : m_scriptPaths)
     {
-        Log::info(L"{}: '{}'", plugin->GetName(), path);
+        Log::info("{}: '{}'", plugin->GetName(), path);
         pathsFile << path.wstring() << std::endl;
     }
-    Log::info(L"Paths written to: '{}'", pathsFilePath);
+    Log::info("Paths written to: '{}'", pathsFilePath);
     format_to(std::back_inserter(buffer), LR"( -compilePathsFile "{}")", pathsFilePath);
     return fmt::to_string(buffer);
 }
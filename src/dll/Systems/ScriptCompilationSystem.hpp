@@ -4,6 +4,7 @@
 #include "ISystem.hpp"
 #include "Paths.hpp"
 #include "PluginBase.hpp"
+#include "ProfiledMutex.hpp"
 #include "SourceRefRepository.hpp"
 
 struct FixedWString
@@ -52,7 +53,7 @@ private:
 
     const Paths& m_paths;
 
-    std::mutex m_mutex;
+    ProfiledMutex m_mutex{"scripts"};
     Map_t m_scriptPaths;
     bool m_hasScriptsBlob;
     std::filesystem::path m_scriptsBlobPath;
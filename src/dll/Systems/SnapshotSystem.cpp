@@ -0,0 +1,195 @@
+#include "stdafx.hpp"
+#include "SnapshotSystem.hpp"
+#include "App.hpp"
+
+#include <cstring>
+
+SnapshotSystem::Channel::Channel(HMODULE aModule, size_t aSize, RED4ext_SnapshotFill_t aFill, void* aUserData)
+    : m_module(aModule)
+    , m_size(aSize)
+    , m_fill(aFill)
+    , m_userData(aUserData)
+{
+    for (auto& buffer : m_buffers)
+    {
+        buffer.data = std::make_unique<std::byte[]>(aSize);
+    }
+}
+
+bool SnapshotSystem::Channel::Read(void* aOut, uint64_t* aFrame) const
+{
+    while (true)
+    {
+        auto frame = m_frame.load(std::memory_order_acquire);
+        if (frame == 0)
+        {
+            return false;
+        }
+
+        const auto& buffer = m_buffers[frame % 2];
+
+        // Odd while the game thread writes into the buffer.
+        auto sequence = buffer.sequence.load(std::memory_order_acquire);
+        if (sequence % 2 != 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // The buffer might have been refilled since 'm_frame' was read, the frame stored with the data is the truth.
+        std::memcpy(aOut, buffer.data.get(), m_size);
+        frame = buffer.frame.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (buffer.sequence.load(std::memory_order_relaxed) == sequence)
+        {
+            if (aFrame)
+            {
+                *aFrame = frame;
+            }
+
+            return true;
+        }
+    }
+}
+
+size_t SnapshotSystem::Channel::GetSize() const
+{
+    return m_size;
+}
+
+void SnapshotSystem::Channel::Publish(RED4ext::CGameApplication* aApp)
+{
+    auto frame = m_frame.load(std::memory_order_relaxed) + 1;
+    auto& buffer = m_buffers[frame % 2];
+
+    auto sequence = buffer.sequence.load(std::memory_order_relaxed);
+    buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    try
+    {
+        m_fill(m_userData, aApp, buffer.data.get());
+    }
+    catch (...)
+    {
+        // 'm_frame' still points at the other buffer, this one is only rewritten next frame.
+        buffer.sequence.store(sequence + 2, std::memory_order_release);
+        throw;
+    }
+
+    buffer.frame.store(frame, std::memory_order_relaxed);
+
+    buffer.sequence.store(sequence + 2, std::memory_order_release);
+    m_frame.store(frame, std::memory_order_release);
+}
+
+ESystemType SnapshotSystem::GetType()
+{
+    return ESystemType::Snapshot;
+}
+
+void SnapshotSystem::Startup()
+{
+}
+
+void SnapshotSystem::Shutdown()
+{
+    auto _ = m_mutex.Lock();
+    m_channels.clear();
+}
+
+SnapshotSystem::Channel* SnapshotSystem::Register(HMODULE aModule, size_t aSize, RED4ext_SnapshotFill_t aFill,
+                                                  void* aUserData)
+{
+    if (aSize == 0 || aSize > MaxSize || !aFill)
+    {
+        return nullptr;
+    }
+
+    auto _ = m_mutex.Lock();
+
+    auto channel = std::make_shared<Channel>(aModule, aSize, aFill, aUserData);
+    return m_channels.emplace_back(std::move(channel)).get();
+}
+
+bool SnapshotSystem::Unregister(HMODULE aModule, Channel* aChannel)
+{
+    auto _ = m_mutex.Lock();
+
+    auto count = std::erase_if(m_channels, [aModule, aChannel](const std::shared_ptr<Channel>& aItem)
+                               { return aItem.get() == aChannel && aItem->m_module == aModule; });
+    return count > 0;
+}
+
+void SnapshotSystem::Unregister(HMODULE aModule)
+{
+    auto _ = m_mutex.Lock();
+    std::erase_if(m_channels, [aModule](const std::shared_ptr<Channel>& aItem) { return aItem->m_module == aModule; });
+}
+
+void SnapshotSystem::Publish(RED4ext::CGameApplication* aApp)
+{
+    // The fill callbacks run without the lock, they may register or unregister channels themselves.
+    {
+        auto _ = m_mutex.Lock();
+        m_publishing.assign(m_channels.begin(), m_channels.end());
+    }
+
+    for (auto& channel : m_publishing)
+    {
+        try
+        {
+            channel->Publish(aApp);
+        }
+        catch (...)
+        {
+            auto plugin = App::Get()->GetPluginSystem()->GetPlugin(channel->m_module);
+            Log::warn("An exception occured while filling a snapshot registered by '{}'",
+                      plugin ? plugin->GetName() : "<unknown>");
+        }
+    }
+
+    m_publishing.clear();
+}
+
+RED4EXT_C_EXPORT void* RED4EXT_CALL RED4ext_SnapshotRegister(RED4ext::PluginHandle aHandle, size_t aSize,
+                                                             RED4ext_SnapshotFill_t aFill, void* aUserData)
+{
+    auto app = App::Get();
+    if (!app)
+    {
+        return nullptr;
+    }
+
+    if (!app->GetPluginSystem()->GetPlugin(aHandle))
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return nullptr;
+    }
+
+    return app->GetSnapshotSystem()->Register(aHandle, aSize, aFill, aUserData);
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_SnapshotUnregister(RED4ext::PluginHandle aHandle, void* aChannel)
+{
+    auto app = App::Get();
+    if (!app)
+    {
+        return false;
+    }
+
+    return app->GetSnapshotSystem()->Unregister(aHandle, static_cast<SnapshotSystem::Channel*>(aChannel));
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_SnapshotRead(const void* aChannel, void* aOut, size_t aSize,
+                                                        uint64_t* aFrame)
+{
+    auto channel = static_cast<const SnapshotSystem::Channel*>(aChannel);
+    if (!channel || !aOut || aSize != channel->GetSize())
+    {
+        return false;
+    }
+
+    return channel->Read(aOut, aFrame);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ISystem.hpp"
+#include "ProfiledMutex.hpp"
+
+/*
+ * Plugin-facing ABI of 'RED4ext_SnapshotRegister'. The fill callback is invoked on the game thread once per frame of
+ * the running state and must write the whole snapshot into 'aSnapshot'.
+ */
+using RED4ext_SnapshotFill_t = void(RED4EXT_CALL*)(void* aUserData, RED4ext::CGameApplication* aApp,
+                                                    void* aSnapshot);
+
+/*
+ * Per-frame snapshots of game data for plugins that read it from other threads. Every snapshot is double buffered and
+ * each buffer is guarded by its own sequence counter (a seqlock), the game thread fills the buffer that was not
+ * published last frame, so a reader only retries when its copy takes longer than a whole frame.
+ */
+class SnapshotSystem : public ISystem
+{
+public:
+    class Channel
+    {
+    public:
+        Channel(HMODULE aModule, size_t aSize, RED4ext_SnapshotFill_t aFill, void* aUserData);
+
+        // Copies the last published snapshot into 'aOut', returns false if nothing was published yet.
+        bool Read(void* aOut, uint64_t* aFrame) const;
+
+        size_t GetSize() const;
+
+    private:
+        friend class SnapshotSystem;
+
+        struct Buffer
+        {
+            alignas(64) std::atomic<uint64_t> sequence{0};
+            std::atomic<uint64_t> frame{0};
+            std::unique_ptr<std::byte[]> data;
+        };
+
+        void Publish(RED4ext::CGameApplication* aApp);
+
+        HMODULE m_module;
+        size_t m_size;
+        RED4ext_SnapshotFill_t m_fill;
+        void* m_userData;
+
+        std::array<Buffer, 2> m_buffers;
+
+        // Number of the last published frame, its snapshot is in 'm_buffers[frame % 2]'.
+        alignas(64) std::atomic<uint64_t> m_frame{0};
+    };
+
+    static constexpr size_t MaxSize = 1024 * 1024;
+
+    ESystemType GetType() final;
+
+    void Startup() final;
+    void Shutdown() final;
+
+    Channel* Register(HMODULE aModule, size_t aSize, RED4ext_SnapshotFill_t aFill, void* aUserData);
+    // Called from another thread than the game's, a fill that already started still completes after these return.
+    bool Unregister(HMODULE aModule, Channel* aChannel);
+    void Unregister(HMODULE aModule);
+
+    // Fills and publishes every snapshot, called by the game thread once per frame of the running state.
+    void Publish(RED4ext::CGameApplication* aApp);
+
+private:
+    ProfiledMutex m_mutex{"snapshot"};
+    std::vector<std::shared_ptr<Channel>> m_channels;
+
+    // Channels being filled by 'Publish', only used by the game thread. Keeps the unregistered ones alive until their
+    // callback returned.
+    std::vector<std::shared_ptr<Channel>> m_publishing;
+};
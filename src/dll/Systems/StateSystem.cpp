@@ -1,7 +1,22 @@
 #include "stdafx.hpp"
 #include "StateSystem.hpp"
+#include "App.hpp"
 #include "Utils.hpp"
 
+#include <algorithm>
+#include <optional>
+
+namespace
+{
+// Weight of the last sample in the moving average of a callback's cost.
+constexpr double CostSmoothing = 0.125;
+
+// Throttled callbacks are relaxed once the expected load drops under this share of the budget.
+constexpr double RelaxRatio = 0.75;
+
+constexpr uint32_t MaxInterval = 32;
+} // namespace
+
 ESystemType StateSystem::GetType()
 {
     return ESystemType::State;
@@ -9,6 +24,9 @@ ESystemType StateSystem::GetType()
 
 void StateSystem::Startup()
 {
+    auto metricsSystem = App::Get()->GetMetricsSystem();
+    m_loadMetric = metricsSystem->Register("state.update.load_us");
+    m_throttledMetric = metricsSystem->Register("state.update.throttled");
 }
 
 void StateSystem::Shutdown()
@@ -31,6 +49,8 @@ void StateSystem::Shutdown()
     m_shutdown.onUpdate.clear();
     m_shutdown.onExit.clear();
 
+    m_policies.clear();
+
     Log::trace("All game states were removed successfully");
 }
 
@@ -47,7 +67,25 @@ bool StateSystem::Add(std::shared_ptr<PluginBase> aPlugin, RED4ext::EGameStateTy
 
         if (aOnUpdate)
         {
-            state->onUpdate.emplace_back(aPlugin, aOnUpdate);
+            auto& item = state->onUpdate.emplace_back(aPlugin, aOnUpdate);
+
+            if (state == &m_running)
+            {
+                const auto name = aPlugin->GetName();
+                auto metricsSystem = App::Get()->GetMetricsSystem();
+
+                auto& throttle = item.throttle;
+                throttle.intervalMetric = metricsSystem->Register(fmt::format("plugins.{}.update.interval", name));
+                throttle.throttledMetric = metricsSystem->Register(fmt::format("plugins.{}.update.throttled", name));
+
+                auto it = m_policies.find(aPlugin->GetModule());
+                if (it != m_policies.end())
+                {
+                    throttle.policy = it->second;
+                }
+
+                SetInterval(item, throttle.policy.interval);
+            }
         }
 
         if (aOnExit)
@@ -59,12 +97,32 @@ bool StateSystem::Add(std::shared_ptr<PluginBase> aPlugin, RED4ext::EGameStateTy
     return state;
 }
 
+void StateSystem::SetUpdatePolicy(std::shared_ptr<PluginBase> aPlugin, const RED4ext_UpdatePolicy& aPolicy)
+{
+    auto policy = aPolicy;
+    policy.priority = std::min<uint32_t>(policy.priority, RED4ext_UpdatePriority_Low);
+    policy.interval = std::clamp<uint32_t>(policy.interval, 1, MaxInterval);
+
+    m_policies.insert_or_assign(aPlugin->GetModule(), policy);
+
+    for (auto& item : m_running.onUpdate)
+    {
+        if (item.plugin == aPlugin)
+        {
+            item.throttle.policy = policy;
+            SetInterval(item, policy.interval);
+        }
+    }
+
+    Log::debug("{} updates with priority {} every {} frame(s)", aPlugin->GetName(), policy.priority, policy.interval);
+}
+
 bool StateSystem::OnEnter(RED4ext::EGameStateType aStateType, RED4ext::CGameApplication* aApp)
 {
     State* state = GetStateByType(aStateType);
     if (state)
     {
-        auto action = fmt::format(L"{}::OnEnter", Utils::GetStateName(aStateType));
+        auto action = fmt::format("{}::OnEnter", Utils::GetStateName(aStateType));
         return Run(action, state->onEnter, aApp);
     }
 
@@ -73,10 +131,26 @@ bool StateSystem::OnEnter(RED4ext::EGameStateType aStateType, RED4ext::CGameAppl
 
 bool StateSystem::OnUpdate(RED4ext::EGameStateType aStateType, RED4ext::CGameApplication* aApp)
 {
+    auto app = App::Get();
+
+    auto ioSystem = app->GetIoSystem();
+    ioSystem->DispatchCompletions();
+
+    if (aStateType == RED4ext::EGameStateType::Running)
+    {
+        auto snapshotSystem = app->GetSnapshotSystem();
+        snapshotSystem->Publish(aApp);
+    }
+
     State* state = GetStateByType(aStateType);
     if (state)
     {
-        auto action = fmt::format(L"{}::OnUpdate", Utils::GetStateName(aStateType));
+        auto action = fmt::format("{}::OnUpdate", Utils::GetStateName(aStateType));
+        if (state == &m_running)
+        {
+            return RunThrottled(action, state->onUpdate, aApp);
+        }
+
         return Run(action, state->onUpdate, aApp);
     }
 
@@ -88,7 +162,7 @@ bool StateSystem::OnExit(RED4ext::EGameStateType aStateType, RED4ext::CGameAppli
     State* state = GetStateByType(aStateType);
     if (state)
     {
-        auto action = fmt::format(L"{}::OnExit", Utils::GetStateName(aStateType));
+        auto action = fmt::format("{}::OnExit", Utils::GetStateName(aStateType));
         return Run(action, state->onExit, aApp);
     }
 
@@ -126,35 +200,205 @@ StateSystem::State* StateSystem::GetStateByType(RED4ext::EGameStateType aStateTy
     return nullptr;
 }
 
-bool StateSystem::Run(std::wstring_view aAction, std::list<StateItem>& aList, RED4ext::CGameApplication* aApp)
+bool StateSystem::Run(std::string_view aAction, std::list<StateItem>& aList, RED4ext::CGameApplication* aApp)
 {
     bool result = true;
     for (auto it = aList.begin(); it != aList.end();)
     {
-        auto pluginName = it->plugin->GetName();
+        if (Invoke(aAction, *it, aApp))
+        {
+            it = aList.erase(it);
+        }
+        else
+        {
+            ++it;
+            result = false;
+        }
+    }
 
-        try
+    return result;
+}
+
+bool StateSystem::RunThrottled(std::string_view aAction, std::list<StateItem>& aList, RED4ext::CGameApplication* aApp)
+{
+    m_frame++;
+
+    bool result = true;
+    double load = 0;
+
+    for (auto it = aList.begin(); it != aList.end();)
+    {
+        auto& throttle = it->throttle;
+        if (m_frame - throttle.lastFrame >= throttle.interval)
         {
-            if (it->func(aApp))
+            throttle.lastFrame = m_frame;
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto isDone = Invoke(aAction, *it, aApp);
+            const std::chrono::duration<double, std::micro> cost = std::chrono::steady_clock::now() - start;
+
+            if (isDone)
             {
                 it = aList.erase(it);
+                continue;
             }
-            else
+
+            const auto sample = cost.count();
+            throttle.cost = throttle.cost == 0 ? sample : throttle.cost + (sample - throttle.cost) * CostSmoothing;
+        }
+
+        load += throttle.cost / throttle.interval;
+
+        ++it;
+        result = false;
+    }
+
+    Rebalance(aList, load);
+    return result;
+}
+
+bool StateSystem::Invoke(std::string_view aAction, StateItem& aItem, RED4ext::CGameApplication* aApp)
+{
+    try
+    {
+        return aItem.func(aApp);
+    }
+    catch (const std::exception& e)
+    {
+        Log::warn("An exception occured while executing '{}' registered by '{}'", aAction, aItem.plugin->GetName());
+        Log::warn(e.what());
+    }
+    catch (...)
+    {
+        Log::warn("An unknown exception occured while executing '{}' registered by '{}'", aAction,
+                  aItem.plugin->GetName());
+    }
+
+    return false;
+}
+
+void StateSystem::Rebalance(std::list<StateItem>& aList, double aLoad)
+{
+    m_loadMetric->Set(static_cast<int64_t>(aLoad));
+
+    const auto budget = static_cast<double>(App::Get()->GetConfigSystem()->GetSnapshot()->plugins.updateBudget);
+    if (budget == 0)
+    {
+        // Throttling is disabled, give back the intervals the plugins asked for.
+        for (auto& item : aList)
+        {
+            if (item.throttle.interval != item.throttle.policy.interval)
             {
-                ++it;
-                result = false;
+                SetInterval(item, item.throttle.policy.interval);
             }
         }
-        catch (const std::exception& e)
+
+        return;
+    }
+
+    // Picks a candidate of the least (or most) important priority that has any, rotating through them so the same
+    // callback does not take every adjustment.
+    auto pick = [&aList](auto aIsCandidate, bool aLeastImportant, uint64_t& aCursor) -> StateItem*
+    {
+        std::optional<uint32_t> priority;
+        for (const auto& item : aList)
         {
-            Log::warn(L"An exception occured while executing '{}' registered by '{}'", aAction, pluginName);
-            Log::warn(e.what());
+            const auto itemPriority = item.throttle.policy.priority;
+            const auto isFurther = aLeastImportant ? itemPriority > priority : itemPriority < priority;
+
+            if (aIsCandidate(item) && (!priority || isFurther))
+            {
+                priority = itemPriority;
+            }
         }
-        catch (...)
+
+        if (!priority)
+        {
+            return nullptr;
+        }
+
+        std::vector<StateItem*> candidates;
+        for (auto& item : aList)
         {
-            Log::warn(L"An unknown exception occured while executing '{}' registered by '{}'", aAction, pluginName);
+            if (aIsCandidate(item) && item.throttle.policy.priority == *priority)
+            {
+                candidates.push_back(&item);
+            }
+        }
+
+        return candidates[aCursor++ % candidates.size()];
+    };
+
+    if (aLoad > budget)
+    {
+        auto item = pick(
+            [](const StateItem& aItem)
+            {
+                return aItem.throttle.policy.priority != RED4ext_UpdatePriority_Critical &&
+                       aItem.throttle.interval < MaxInterval;
+            },
+            true, m_throttleCursor);
+
+        if (item)
+        {
+            SetInterval(*item, item->throttle.interval * 2);
+
+            item->throttle.throttledMetric->Add(1);
+            m_throttledMetric->Add(1);
+
+            Log::debug("The updates are over the budget ({:.0f} us / {:.0f} us), {} updates every {} frame(s)", aLoad,
+                       budget, item->plugin->GetName(), item->throttle.interval);
         }
     }
+    else if (aLoad < budget * RelaxRatio)
+    {
+        auto item = pick([](const StateItem& aItem)
+                         { return aItem.throttle.interval > aItem.throttle.policy.interval; },
+                         false, m_relaxCursor);
 
-    return result;
+        if (item)
+        {
+            const auto& throttle = item->throttle;
+            const auto interval = std::max(throttle.interval / 2, throttle.policy.interval);
+
+            // Only relax if the callback's extra cost keeps the load under the threshold, otherwise it oscillates.
+            const auto extra = throttle.cost / interval - throttle.cost / throttle.interval;
+            if (aLoad + extra < budget * RelaxRatio)
+            {
+                SetInterval(*item, interval);
+                Log::debug("{} updates every {} frame(s)", item->plugin->GetName(), interval);
+            }
+        }
+    }
+}
+
+void StateSystem::SetInterval(StateItem& aItem, uint32_t aInterval)
+{
+    auto& throttle = aItem.throttle;
+    throttle.interval = std::clamp(aInterval, throttle.policy.interval, MaxInterval);
+
+    if (throttle.intervalMetric)
+    {
+        throttle.intervalMetric->Set(throttle.interval);
+    }
+}
+
+RED4EXT_C_EXPORT bool RED4EXT_CALL RED4ext_SetUpdatePolicy(RED4ext::PluginHandle aHandle,
+                                                           const RED4ext_UpdatePolicy* aPolicy)
+{
+    auto app = App::Get();
+    if (!app || !aPolicy)
+    {
+        return false;
+    }
+
+    auto plugin = app->GetPluginSystem()->GetPlugin(aHandle);
+    if (!plugin)
+    {
+        Log::warn("Could not find a plugin with handle {}", fmt::ptr(aHandle));
+        return false;
+    }
+
+    app->GetStateSystem()->SetUpdatePolicy(plugin, *aPolicy);
+    return true;
 }
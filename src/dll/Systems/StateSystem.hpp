@@ -1,8 +1,28 @@
 #pragma once
 
 #include "ISystem.hpp"
+#include "MetricsSystem.hpp"
 #include "PluginBase.hpp"
 
+/*
+ * Plugin-facing ABI of 'RED4ext_SetUpdatePolicy'. 'interval' is the number of frames between two 'Running' updates of
+ * the plugin (0 and 1 mean every frame). When the updates exceed the frame budget ('plugins.update_budget_us'), the
+ * callbacks with the lowest priority are throttled first, critical ones never are.
+ */
+enum RED4ext_UpdatePriority : uint32_t
+{
+    RED4ext_UpdatePriority_Critical,
+    RED4ext_UpdatePriority_High,
+    RED4ext_UpdatePriority_Normal,
+    RED4ext_UpdatePriority_Low
+};
+
+struct RED4ext_UpdatePolicy
+{
+    uint32_t priority;
+    uint32_t interval;
+};
+
 class StateSystem : public ISystem
 {
 public:
@@ -16,15 +36,34 @@ public:
     bool Add(std::shared_ptr<PluginBase> aPlugin, RED4ext::EGameStateType aStateType, Func_t aOnEnter, Func_t aOnUpdate,
              Func_t aOnExit);
 
+    // Applies to the 'Running' updates the plugin registered and to the ones it registers later.
+    void SetUpdatePolicy(std::shared_ptr<PluginBase> aPlugin, const RED4ext_UpdatePolicy& aPolicy);
+
     bool OnEnter(RED4ext::EGameStateType aStateType, RED4ext::CGameApplication* aApp);
     bool OnUpdate(RED4ext::EGameStateType aStateType, RED4ext::CGameApplication* aApp);
     bool OnExit(RED4ext::EGameStateType aStateType, RED4ext::CGameApplication* aApp);
 
 private:
+    struct Throttle
+    {
+        RED4ext_UpdatePolicy policy{RED4ext_UpdatePriority_Normal, 1};
+
+        // Frames between two updates, never lower than the interval the plugin asked for.
+        uint32_t interval = 1;
+        uint64_t lastFrame = 0;
+
+        // Moving average of the callback's cost, in microseconds.
+        double cost = 0;
+
+        MetricsSystem::Metric* intervalMetric = nullptr;
+        MetricsSystem::Metric* throttledMetric = nullptr;
+    };
+
     struct StateItem
     {
         std::shared_ptr<PluginBase> plugin;
         Func_t func;
+        Throttle throttle{};
     };
 
     struct State
@@ -36,10 +75,27 @@ private:
 
     State* GetStateByType(RED4ext::EGameStateType aStateType);
 
-    bool Run(std::wstring_view aAction, std::list<StateItem>& aList, RED4ext::CGameApplication* aApp);
+    bool Run(std::string_view aAction, std::list<StateItem>& aList, RED4ext::CGameApplication* aApp);
+    bool RunThrottled(std::string_view aAction, std::list<StateItem>& aList, RED4ext::CGameApplication* aApp);
+
+    // Returns true if the callback is done and should be removed.
+    bool Invoke(std::string_view aAction, StateItem& aItem, RED4ext::CGameApplication* aApp);
+
+    // Throttles or relaxes one callback per frame, depending on the expected load against the budget.
+    void Rebalance(std::list<StateItem>& aList, double aLoad);
+    void SetInterval(StateItem& aItem, uint32_t aInterval);
 
     State m_baseInitialization;
     State m_initialization;
     State m_running;
     State m_shutdown;
+
+    std::unordered_map<HMODULE, RED4ext_UpdatePolicy> m_policies;
+
+    uint64_t m_frame = 0;
+    uint64_t m_throttleCursor = 0;
+    uint64_t m_relaxCursor = 0;
+
+    MetricsSystem::Metric* m_loadMetric = nullptr;
+    MetricsSystem::Metric* m_throttledMetric = nullptr;
 };
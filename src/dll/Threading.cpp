@@ -0,0 +1,123 @@
+#include "stdafx.hpp"
+#include "Threading.hpp"
+
+#ifdef RED4EXT_PLATFORM_MACOS
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if !defined(RED4EXT_PLATFORM_MACOS) && defined(__linux__)
+// The kernel truncates longer names.
+constexpr size_t MaxNameLength = 15;
+
+void RestrictAffinity()
+{
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    {
+        return;
+    }
+
+    const auto count = CPU_COUNT(&allowed);
+    if (count < 2)
+    {
+        return;
+    }
+
+    cpu_set_t upper;
+    CPU_ZERO(&upper);
+
+    int index = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &allowed) && index++ >= count / 2)
+        {
+            CPU_SET(cpu, &upper);
+        }
+    }
+
+    sched_setaffinity(0, sizeof(upper), &upper);
+}
+#endif
+} // namespace
+
+void Threading::ApplyPolicy(std::string_view aName, Priority aPriority)
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    std::string name(aName);
+    pthread_setname_np(name.c_str());
+
+    auto qos = aPriority == Priority::Utility ? QOS_CLASS_UTILITY : QOS_CLASS_BACKGROUND;
+    if (pthread_set_qos_class_self_np(qos, 0) != 0)
+    {
+        Log::warn("Could not set the QoS class of thread '{}'", name);
+    }
+#elif defined(__linux__)
+    std::string name(aName.substr(0, MaxNameLength));
+    pthread_setname_np(pthread_self(), name.c_str());
+
+    // Niceness is per thread on Linux.
+    auto nice = aPriority == Priority::Utility ? 5 : 10;
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), nice);
+
+    RestrictAffinity();
+#else
+    std::wstring name(aName.begin(), aName.end());
+    SetThreadDescription(GetCurrentThread(), name.c_str());
+
+    auto priority = aPriority == Priority::Utility ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_LOWEST;
+    SetThreadPriority(GetCurrentThread(), priority);
+
+    THREAD_POWER_THROTTLING_STATE throttling{};
+    throttling.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+    throttling.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+    throttling.StateMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+
+    SetThreadInformation(GetCurrentThread(), ThreadPowerThrottling, &throttling, sizeof(throttling));
+#endif
+}
+
+RED4EXT_C_EXPORT void* RED4EXT_CALL RED4ext_StartThread(const char* aName, uint32_t aPriority,
+                                                        RED4ext_ThreadFunc_t aFunc, void* aUserData)
+{
+    if (!aName || !aFunc || aPriority > static_cast<uint32_t>(Threading::Priority::Background))
+    {
+        return nullptr;
+    }
+
+    // Exceptions must not cross into the plugin.
+    try
+    {
+        auto thread = Threading::Start(aName, static_cast<Threading::Priority>(aPriority), aFunc, aUserData);
+        return new std::thread(std::move(thread));
+    }
+    catch (const std::exception& e)
+    {
+        Log::warn("Could not start the '{}' thread. Error: {}", aName, e.what());
+        return nullptr;
+    }
+}
+
+RED4EXT_C_EXPORT void RED4EXT_CALL RED4ext_JoinThread(void* aThread)
+{
+    auto thread = static_cast<std::thread*>(aThread);
+    if (!thread)
+    {
+        return;
+    }
+
+    if (thread->joinable())
+    {
+        thread->join();
+    }
+
+    delete thread;
+}
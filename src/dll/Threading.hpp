@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+
+/*
+ * Every thread RED4ext starts, or starts on behalf of a plugin, goes through the same policy so auxiliary work stays
+ * off the cores the game's render and job threads need:
+ *
+ *  macOS   - QoS class (utility or background), the scheduler places these threads on the efficiency cores.
+ *  Windows - lowered priority and EcoQoS (execution speed throttling).
+ *  Linux   - niceness and an affinity mask leaving the lower half of the allowed CPUs alone, used for testing.
+ */
+namespace Threading
+{
+enum class Priority : uint8_t
+{
+    // Work the game ends up waiting for (I/O completions, script compilation).
+    Utility,
+    // Work nobody waits for (watchers, profilers, telemetry).
+    Background
+};
+
+// Names the calling thread and applies the policy of the priority to it.
+void ApplyPolicy(std::string_view aName, Priority aPriority);
+
+template<typename Func, typename... Args>
+std::thread Start(std::string aName, Priority aPriority, Func&& aFunc, Args&&... aArgs)
+{
+    return std::thread(
+        [name = std::move(aName), aPriority, func = std::forward<Func>(aFunc),
+         ... args = std::forward<Args>(aArgs)]() mutable
+        {
+            ApplyPolicy(name, aPriority);
+            std::invoke(std::move(func), std::move(args)...);
+        });
+}
+} // namespace Threading
+
+/*
+ * Plugin-facing ABI of 'RED4ext_StartThread'. 'aPriority' is a 'Threading::Priority' value, the returned thread must be
+ * joined with 'RED4ext_JoinThread' before the plugin is unloaded. It returns null when the thread can not be started.
+ */
+using RED4ext_ThreadFunc_t = void(RED4EXT_CALL*)(void* aUserData);
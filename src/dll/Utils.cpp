@@ -16,7 +16,7 @@
 #include <locale>
 #endif
 
-std::shared_ptr<spdlog::logger> Utils::CreateLogger(const std::wstring_view aLogName, const std::wstring_view aFilename,
+std::shared_ptr<spdlog::logger> Utils::CreateLogger(const std::string_view aLogName, const std::string_view aFilename,
                                                     const Paths& aPaths, const Config& aConfig,
                                                     const DevConsole& aDevConsole)
 {
@@ -64,8 +64,8 @@ std::shared_ptr<spdlog::logger> Utils::CreateLogger(const std::wstring_view aLog
         size_t maxFiles = loggingConfig.maxFiles;
         size_t maxFileSize = static_cast<size_t>(loggingConfig.maxFileSize) * oneMbInB;
 
-        auto file = dir / aFilename;
-        auto logger = spdlog::rotating_logger_mt(Narrow(aLogName), file, maxFileSize, maxFiles, true);
+        auto file = dir / ToPath(aFilename);
+        auto logger = spdlog::rotating_logger_mt(std::string(aLogName), file, maxFileSize, maxFiles, true);
         logger->set_level(loggingConfig.level);
         logger->flush_on(loggingConfig.flushOn);
 
@@ -98,30 +98,30 @@ std::shared_ptr<spdlog::logger> Utils::CreateLogger(const std::wstring_view aLog
     return nullptr;
 }
 
-std::wstring Utils::GetStateName(RED4ext::EGameStateType aStateType)
+std::string_view Utils::GetStateName(RED4ext::EGameStateType aStateType)
 {
     using enum RED4ext::EGameStateType;
     switch (aStateType)
     {
     case BaseInitialization:
     {
-        return L"BaseInitialization";
+        return "BaseInitialization";
     }
     case Initialization:
     {
-        return L"Initialization";
+        return "Initialization";
     }
     case Running:
     {
-        return L"Running";
+        return "Running";
     }
     case Shutdown:
     {
-        return L"Shutdown";
+        return "Shutdown";
     }
     default:
     {
-        return L"unknown";
+        return "unknown";
     }
     }
 }
@@ -166,7 +166,7 @@ std::wstring Utils::FormatLastError()
     return FormatSystemMessage(err);
 }
 
-std::wstring Utils::FormatCurrentTimestamp()
+std::string Utils::FormatCurrentTimestamp()
 {
     auto now = std::chrono::system_clock::now();
     std::time_t now_c = std::chrono::system_clock::to_time_t(now);
@@ -179,7 +179,7 @@ std::wstring Utils::FormatCurrentTimestamp()
     localtime_s(&now_tm, &now_c);
 #endif
 
-    return fmt::format(L"{:04d}-{:02d}-{:02d}-{:02d}-{:02d}-{:02d}", now_tm.tm_year + 1900, now_tm.tm_mon + 1,
+    return fmt::format("{:04d}-{:02d}-{:02d}-{:02d}-{:02d}-{:02d}", now_tm.tm_year + 1900, now_tm.tm_mon + 1,
                        now_tm.tm_mday, now_tm.tm_hour, now_tm.tm_min, now_tm.tm_sec);
 }
 
@@ -271,10 +271,50 @@ std::wstring Utils::Widen(const std::string_view aText)
     return result;
 }
 
-std::wstring Utils::ToLower(const std::wstring& acText)
+std::filesystem::path Utils::ToPath(const std::string_view aText)
 {
-    std::wstring text = acText;
+#ifdef RED4EXT_PLATFORM_MACOS
+    return std::filesystem::path(aText);
+#else
+    return std::filesystem::path(std::u8string_view(reinterpret_cast<const char8_t*>(aText.data()), aText.size()));
+#endif
+}
+
+std::string Utils::ToString(const std::filesystem::path& aPath)
+{
+#ifdef RED4EXT_PLATFORM_MACOS
+    return aPath.native();
+#else
+    return Narrow(aPath.native());
+#endif
+}
+
+std::string Utils::ToLower(const std::string_view aText)
+{
+    std::string text(aText);
+
+    auto isAscii = true;
+    for (auto& c : text)
+    {
+        if (static_cast<unsigned char>(c) >= 0x80)
+        {
+            isAscii = false;
+            break;
+        }
+
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+
+    if (isAscii)
+    {
+        return text;
+    }
+
+    auto wide = Widen(aText);
+    std::transform(wide.begin(), wide.end(), wide.begin(), std::towlower);
 
-    std::transform(text.begin(), text.end(), text.begin(), std::towlower);
-    return text;
+    return Narrow(wide);
 }
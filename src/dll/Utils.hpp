@@ -8,14 +8,14 @@ class Paths;
 
 namespace Utils
 {
-std::shared_ptr<spdlog::logger> CreateLogger(const std::wstring_view aLogName, const std::wstring_view aFilename,
+std::shared_ptr<spdlog::logger> CreateLogger(const std::string_view aLogName, const std::string_view aFilename,
                                              const Paths& aPaths, const Config& aConfig, const DevConsole& aDevConsole);
 
-std::wstring GetStateName(RED4ext::EGameStateType aStateType);
+std::string_view GetStateName(RED4ext::EGameStateType aStateType);
 
 std::wstring FormatSystemMessage(uint32_t aMessageId);
 std::wstring FormatLastError();
-std::wstring FormatCurrentTimestamp();
+std::string FormatCurrentTimestamp();
 
 int32_t ShowMessageBoxEx(const std::wstring_view aCaption, const std::wstring_view aText, uint32_t aType = MB_OK);
 int32_t ShowMessageBox(const std::wstring_view aText, uint32_t aType = MB_OK);
@@ -23,7 +23,12 @@ int32_t ShowMessageBox(const std::wstring_view aText, uint32_t aType = MB_OK);
 std::string Narrow(const std::wstring_view aText);
 std::wstring Widen(const std::string_view aText);
 
-std::wstring ToLower(const std::wstring& acText);
+// Paths and UTF-8 text, without going through the ANSI code page on Windows.
+std::filesystem::path ToPath(const std::string_view aText);
+std::string ToString(const std::filesystem::path& aPath);
+
+// ASCII text is lowered as is, other text goes through a wide string.
+std::string ToLower(const std::string_view aText);
 
 template<typename... Args>
 int32_t ShowMessageBox(uint32_t aType, const std::wstring_view aText, Args&&... aArgs)
@@ -76,13 +81,23 @@ struct fmt::formatter<std::filesystem::path, wchar_t> : formatter<std::wstring_v
     }
 };
 #else
-template<typename Char>
-struct fmt::formatter<std::filesystem::path, Char> : formatter<basic_string_view<Char>, Char>
+template<>
+struct fmt::formatter<std::filesystem::path, char> : formatter<std::string_view, char>
+{
+    template<typename FormatContext>
+    auto format(const std::filesystem::path& path, FormatContext& ctx)
+    {
+        return formatter<std::string_view, char>::format(Utils::ToString(path), ctx);
+    }
+};
+
+template<>
+struct fmt::formatter<std::filesystem::path, wchar_t> : formatter<std::wstring_view, wchar_t>
 {
     template<typename FormatContext>
     auto format(const std::filesystem::path& path, FormatContext& ctx)
     {
-        return formatter<basic_string_view<Char>, Char>::format(path.c_str(), ctx);
+        return formatter<std::wstring_view, wchar_t>::format(path.c_str(), ctx);
     }
 };
 #endif
@@ -0,0 +1,7 @@
+#pragma once
+
+#define RED4EXT_VERSION_MAJOR 0
+#define RED4EXT_VERSION_MINOR 0
+#define RED4EXT_VERSION_PATCH 0
+
+#define RED4EXT_VERSION_STR "0.0.0+master.37e7006.20261018T133419Z"
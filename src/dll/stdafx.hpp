@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
 #include <cstdint>
 #include <ctime>
@@ -14,7 +16,10 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #ifndef RED4EXT_PLATFORM_MACOS
 #include <Windows.h>
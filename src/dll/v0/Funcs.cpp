@@ -101,12 +101,12 @@ bool v0::GameStates::Add(RED4ext::PluginHandle aHandle, RED4ext::EGameStateType
     auto stateSystem = app->GetStateSystem();
     if (stateSystem->Add(plugin, aType, aState->OnEnter, aState->OnUpdate, aState->OnExit))
     {
-        Log::trace(L"The request to add a '{}' state for '{}' has been successfully completed",
+        Log::trace("The request to add a '{}' state for '{}' has been successfully completed",
                       Utils::GetStateName(aType), plugin->GetName());
         return true;
     }
 
-    Log::warn(L"The request to add a '{}' state for '{}' has failed", Utils::GetStateName(aType), plugin->GetName());
+    Log::warn("The request to add a '{}' state for '{}' has failed", Utils::GetStateName(aType), plugin->GetName());
     return false;
 }
 
@@ -99,13 +99,13 @@ inline int macos_vsnwprintf(wchar_t* buffer, size_t bufsize, size_t /*maxcount*/
         }                                                                                                              \
         else if (res < 0)                                                                                              \
         {                                                                                                              \
-            Log::warn(L"Could not format the log message logged by '{}'. '" #format_fn "' returned {}",             \
+            Log::warn("Could not format the log message logged by '{}'. '" #format_fn "' returned {}",              \
                          plugin->GetName(), res);                                                                      \
         }                                                                                                              \
     }                                                                                                                  \
     else if (len < 0)                                                                                                  \
     {                                                                                                                  \
-        Log::warn(L"Could not get the length of the formatted log message logged by '{}'. '" #count_fn              \
+        Log::warn("Could not get the length of the formatted log message logged by '{}'. '" #count_fn               \
                      "' returned {}",                                                                                  \
                      plugin->GetName(), len);                                                                          \
     }                                                                                                                  \
@@ -1,5 +1,6 @@
 #include "v0/Plugin.hpp"
 #include "Image.hpp"
+#include "Utils.hpp"
 #include "stdafx.hpp"
 #include "v0/Funcs.hpp"
 #include "v0/Logger.hpp"
@@ -70,14 +71,20 @@ const void* v0::Plugin::GetSdkStruct() const
     return &m_sdk;
 }
 
-const std::wstring_view v0::Plugin::GetName() const
+void v0::Plugin::CacheInfo()
 {
-    return m_info.name;
+    m_name = m_info.name ? Utils::Narrow(m_info.name) : "";
+    m_author = m_info.author ? Utils::Narrow(m_info.author) : "";
 }
 
-const std::wstring_view v0::Plugin::GetAuthor() const
+const std::string_view v0::Plugin::GetName() const
 {
-    return m_info.author;
+    return m_name;
+}
+
+const std::string_view v0::Plugin::GetAuthor() const
+{
+    return m_author;
 }
 
 const RED4ext::SemVer& v0::Plugin::GetVersion() const
@@ -13,14 +13,19 @@ public:
     void* GetPluginInfo() final;
     const void* GetSdkStruct() const final;
 
-    virtual const std::wstring_view GetName() const final;
-    virtual const std::wstring_view GetAuthor() const final;
+    virtual const std::string_view GetName() const final;
+    virtual const std::string_view GetAuthor() const final;
     virtual const RED4ext::SemVer& GetVersion() const final;
     virtual const RED4ext::FileVer& GetRuntimeVersion() const final;
     virtual const RED4ext::SemVer& GetSdkVersion() const final;
 
+protected:
+    void CacheInfo() final;
+
 private:
     RED4ext::v0::PluginInfo m_info;
+    std::string m_name;
+    std::string m_author;
 
     RED4ext::v0::Sdk m_sdk;
     RED4ext::v0::SemVer m_runtime;